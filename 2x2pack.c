@@ -8,53 +8,69 @@
  *
  *     summary:
  *
- *     This file contains the packBlock() and unpackBlock() functions,
- *     which pack the pixels of a PPM image in 2x2 regions into block (for 
- *     compression) or unpack those blocks into 4 pixels (for 
- *     decompression), respectively. Also implements helper functions
- *     to achieve this.
+ *     This file contains the rgbToBlock() and unpackBlock() functions,
+ *     which pack the pixels of a PPM image in 2x2 regions into blocks (for
+ *     compression), converting them from RGB color space on the way, or
+ *     unpack those blocks into 4 pixels (for decompression), respectively.
+ *     Also implements helper functions to achieve this.
  *
  **************************************************************/
 #include <stdlib.h>
 #include "a2methods.h"
+#include "a2extended.h"
 #include "assert.h"
 #include "2x2pack.h"
+#include "colorKernel.h"
+#include "colorTable.h"
 
 const int BLOCK_SIZE = 2;
 
-/************************ packBlock ******************************
+/* The blocks rgbToBlock() converts the pixels of at once, and the pixels
+   in one row of them (BLOCK_SIZE per block); enums so the row buffers of
+   packRgbBlockSpan() are arrays of fixed size */
+enum { CHUNK_BLOCKS = 64, CHUNK_PIXELS = 2 * CHUNK_BLOCKS };
+
+static void convertSpan(const struct A2Span *span, int first, int count,
+                        unsigned denominator, struct YPbPr_pixel *out);
+
+/************************ rgbToBlock ******************************
+ *
+ * Converts an image from RGB color space and packs it into blocks in one
+ * stage, converting each pixel exactly as pixelToYPbPr() would and
+ * packing each 2x2 region with averageChroma() and pixelToDCT(), without
+ * storing the image in component video color space. Stores the blocks in
+ * a A2Methods_UArray2 that will be returned.
  *
- * Packs the given image PPM (in component video color space) into
- * blocks of pixels, using averages and the discrete cosine transform (DCT)
- * function. Stores these blocks in a A2Methods_UArray2 that will be 
- * returned.
- * 
  * Parameters:
- *        A2Methods_UArray2 original: a pointer to a UArray2 storing 
- *        YPbPr_pixel structs, which represents an image in the PPM format 
- *        with the pixels in the component video space.
+ *        A2Methods_UArray2 original: a pointer to a UArray2 storing
+ *        Pnm_rgb structs, which represents the pixels in RGB color space
+ *        unsigned denominator: an unsigned integer representing the
+ *        maximum color value of the PPM
  *        const struct A2Methods_T *methods: A pointer to a A2Methods_T struct
  *        that contains pointers to functions on can use on a UArray
- * 
- * Return: 
+ *        int threads: the number of threads to run the stage on,
+ *        counting the calling thread
+ *
+ * Return:
  *         A pointer to a newly allocated and initialzed A2Methods_UArray2 of
- *         YPbPr_block structs, which represent the pixels of a PPM packed 
+ *         YPbPr_block structs, which represent the pixels of a PPM packed
  *         into blocks
- * 
+ *
  * Expects
  *         original and methods to not be NULL
- *         the pixels stored in original to be in the component video space
- *         and its dimensions to be multiples of BLOCK_SIZE
+ *         its dimensions to be multiples of BLOCK_SIZE
  *
  * Notes:
  *         Allocates memory for a A2Methods_UArray2 struct (destination) that
  *         the caller is responsible for freeing using methods->free()
+ *         Only a few blocks' worth of pixels are ever held in component
+ *         video color space, instead of a whole image of them.
  *         Will raise a CRE if original or methods is NULL or if
  *         methods->new() fails.
  *
  ************************************************************/
-A2Methods_UArray2 packBlock(A2Methods_UArray2 original,
-                            const struct A2Methods_T *methods)
+A2Methods_UArray2 rgbToBlock(A2Methods_UArray2 original, unsigned denominator,
+                             const struct A2Methods_T *methods, int threads)
 {
         assert(original != NULL && methods != NULL);
         A2Methods_UArray2 destination =
@@ -62,67 +78,123 @@ A2Methods_UArray2 packBlock(A2Methods_UArray2 original,
                              methods->height(original) / BLOCK_SIZE,
                              sizeof(struct YPbPr_block));
 
-        struct Closure cl = { .array = original, .methods = methods };
+        struct Closure cl = { .array = original,
+                              .methods = methods,
+                              .denominator = denominator };
 
-        methods->map_default(destination, packBlockApply, &cl);
+        A2Extended(methods)->map_spans_parallel(destination, threads,
+                                                packRgbBlockSpan, &cl);
 
         return destination;
 }
 
 /*
- * Name:       packBlockApply
- * Purpose:    Packs a 2x2 region of pixels (in component video color space)
- *             from the original image into a single YPbPr_block. Computes
- *             the average chroma (Pb, Pr) values and the discrete cosine
- *             transform (DCT) coefficients for the luminance (Y) values.
- * Parameters: int col: an integer representing the distance between the
- *             current element and the left edge of the array
- *             int row: an integer representing the distance between the
- *             current element and the top of the array
- *             A2Methods_UArray2 array2: required by the A2Methods_Object
- *             interface; ignored here
- *             A2Methods_Object *elem: a pointer to a YPbPr_block representing 
- *             a 2x2 block of pixels of the image
+ * Name:       packRgbBlockSpan
+ * Purpose:    Packs the 2x2 regions of pixels (in RGB color space) under a
+ *             span of blocks, converting them to component video color
+ *             space a few blocks at a time on the way
+ * Parameters: int col: the column of the first element of the span
+ *             int row: the row of the span
+ *             int count: the number of elements in the span
+ *             A2Methods_Object *base: a pointer to the first YPbPr_block of
+ *             the span
+ *             int stride: the number of bytes from one element of
+ *             the span to the next
  *             void *cl: a pointer to a Closure struct containing a pointer
- *             to a A2Methods_UArray2 (the original image in YPbPr_pixel
- *             format) and a pointer to an A2Methods_T struct with function
- *             pointers for operating on the array
+ *             to a A2Methods_UArray2 (the original image in Pnm_rgb
+ *             format), a pointer to an A2Methods_T struct with function
+ *             pointers for operating on the array, and the maximum color
+ *             value of the PPM
  * Returns:    None
- * Expects:    elem to not be NULL and cl points to a Closure struct that
- *             stores a non-NULL A2Methods_UArray2 and A2Methods_T struct 
+ * Expects:    base to not be NULL and cl points to a Closure struct that
+ *             stores a non-NULL A2Methods_UArray2 and A2Methods_T struct
  *             and is not NULL
- *             col and row are within the bounds of the array
+ *             the span is within the bounds of the array
  * Notes:      will CRE if cl is NULL or its array or methods field is NULL
- *             will CRE if elem is NULL
- *             If col or row are not valid, the methods->at function will 
- *             throw a CRE
+ *             will CRE if base is NULL
+ *             Each pixel is converted exactly as pixelToYPbPr() would, and
+ *             averaged by averageChroma(), so the blocks are the same as the
+ *             fused kernels of codeword.c make. Only CHUNK_BLOCKS blocks'
+ *             worth of pixels wait on the stack in between, not a whole
+ *             image of them.
  */
-void packBlockApply(int col, int row, A2Methods_UArray2 array2, void *elem,
-                    void *cl)
+void packRgbBlockSpan(int col, int row, int count, A2Methods_Object *base,
+                      int stride, void *cl)
 {
-        assert(elem != NULL && cl != NULL);
+        assert(base != NULL && cl != NULL);
 
         struct Closure *closure = cl;
-        assert(closure->array != NULL && closure != NULL &&
+        assert(closure != NULL && closure->array != NULL &&
                closure->methods != NULL);
 
-        A2Methods_UArray2 original = closure->array;
-        const struct A2Methods_T *methods = closure->methods;
-
         col *= BLOCK_SIZE;
         row *= BLOCK_SIZE;
 
-        struct YPbPr_block *currBlock = elem;
-
-        struct YPbPr_pixel *pixel1 = methods->at(original, col, row);
-        struct YPbPr_pixel *pixel2 = methods->at(original, col + 1, row);
-        struct YPbPr_pixel *pixel3 = methods->at(original, col, row + 1);
-        struct YPbPr_pixel *pixel4 = methods->at(original, col + 1, row + 1);
-
-        averageChroma(pixel1, pixel2, pixel3, pixel4, currBlock);
-        pixelToDCT(pixel1->Y, pixel2->Y, pixel3->Y, pixel4->Y, currBlock);
+        struct A2Span top = A2Span_new(closure->methods, closure->array, col,
+                                       row, count * BLOCK_SIZE);
+        struct A2Span bottom = A2Span_new(closure->methods, closure->array,
+                                          col, row + 1, count * BLOCK_SIZE);
+        struct YPbPr_pixel upper[CHUNK_PIXELS];
+        struct YPbPr_pixel lower[CHUNK_PIXELS];
+        char *blocks = base;
+
+        for (int first = 0; first < count; first += CHUNK_BLOCKS) {
+                int chunk = count - first;
+                if (chunk > CHUNK_BLOCKS) {
+                        chunk = CHUNK_BLOCKS;
+                }
+                convertSpan(&top, BLOCK_SIZE * first, BLOCK_SIZE * chunk,
+                            closure->denominator, upper);
+                convertSpan(&bottom, BLOCK_SIZE * first, BLOCK_SIZE * chunk,
+                            closure->denominator, lower);
+
+                for (int i = 0; i < chunk; i++) {
+                        struct YPbPr_block *currBlock = (struct YPbPr_block *)
+                                (blocks + (long) (first + i) * stride);
+
+                        struct YPbPr_pixel *pixel1 = &upper[2 * i];
+                        struct YPbPr_pixel *pixel2 = &upper[2 * i + 1];
+                        struct YPbPr_pixel *pixel3 = &lower[2 * i];
+                        struct YPbPr_pixel *pixel4 = &lower[2 * i + 1];
+
+                        averageChroma(pixel1, pixel2, pixel3, pixel4,
+                                      currBlock);
+                        pixelToDCT(pixel1->Y, pixel2->Y, pixel3->Y,
+                                   pixel4->Y, currBlock);
+                }
+        }
+}
 
-        (void) array2;
+/*
+ * Name:       convertSpan
+ * Purpose:    a private function that converts part of a run of pixels
+ *             from RGB to component video color space
+ * Parameters: const struct A2Span *span: the run of Pnm_rgb pixels
+ *             int first: the first pixel of the run to convert
+ *             int count: the number of pixels to convert
+ *             unsigned denominator: the maximum color value of the PPM
+ *             struct YPbPr_pixel *out: where the count converted pixels are
+ *             stored
+ * Return:     None
+ * Expects:    span and out to not be NULL, and the pixels to be in the run
+ * Notes:      converts the pixels at once with rgbRowToYPbPr() when the
+ *             run is stored as an array, and looks each one up in the
+ *             tables of colorTable.c when it is not
+ */
+static void convertSpan(const struct A2Span *span, int first, int count,
+                        unsigned denominator, struct YPbPr_pixel *out)
+{
+        if (span->base != NULL && span->stride == sizeof(struct Pnm_rgb)) {
+                const struct Pnm_rgb *pixels =
+                        (const struct Pnm_rgb *) span->base + first;
+                rgbRowToYPbPr(pixels, out, count, denominator);
+                return;
+        }
+
+        const struct Color_table *table = colorTable(denominator);
+        for (int i = 0; i < count; i++) {
+                out[i] = tableToYPbPr(table, A2Span_at(span, first + i));
+        }
 }
 
 /*
@@ -192,6 +264,8 @@ void pixelToDCT(float Y1, float Y2, float Y3, float Y4,
  *        make up a compressed PPM image
  *        const struct A2Methods_T *methods: A pointer to a A2Methods_T struct
  *        that contains pointers to functions on can use on a UArray
+ *        int threads: the number of threads to run the stage on,
+ *        counting the calling thread
  * 
  * Return: 
  *         A pointer to a newly allocated and initialzed A2Methods_UArray2 of
@@ -210,7 +284,7 @@ void pixelToDCT(float Y1, float Y2, float Y3, float Y4,
  *
  ************************************************************/
 A2Methods_UArray2 unpackBlock(A2Methods_UArray2 original,
-                              const struct A2Methods_T *methods)
+                              const struct A2Methods_T *methods, int threads)
 {
         assert(original != NULL && methods != NULL);
         A2Methods_UArray2 destination =
@@ -220,48 +294,49 @@ A2Methods_UArray2 unpackBlock(A2Methods_UArray2 original,
 
         struct Closure cl = { .array = destination, .methods = methods };
 
-        methods->map_default(original, unpackBlockApply, &cl);
+        A2Extended(methods)->map_spans_parallel(original, threads,
+                                                unpackBlockSpan, &cl);
 
         struct Closure cl2 = { .array = original, .methods = methods };
 
-        methods->map_default(destination, setChromaApply, &cl2);
+        A2Extended(methods)->map_spans_parallel(destination, threads,
+                                                setChromaSpan, &cl2);
 
         return destination;
 }
 
 /*
- * Name:       unpackBlockApply
+ * Name:       unpackBlockSpan
  * Purpose:    Unpacks a YPbPr_block from the compressed image into a 2x2
  *             region of pixels (in component video color space). Uses the 
  *             inverse of the discrete cosine transform to compute Y1, 
  *             Y2, Y3, and Y4 from a, b, c, and d.
- * Parameters: int col: an integer representing the distance between the
- *             current element and the left edge of the array
- *             int row: an integer representing the distance between the
- *             current element and the top of the array
- *             A2Methods_UArray2 array2: required by the A2Methods_Object
- *             interface; ignored here
- *             A2Methods_Object *elem: a pointer to a YPbPr_block representing 
- *             the current block of the image transformed into component video 
- *             color space
+ * Parameters: int col: the column of the first element of the span
+ *             int row: the row of the span
+ *             int count: the number of elements in the span
+ *             A2Methods_Object *base: a pointer to the first YPbPr_block of
+ *             the span, each representing a block of the image transformed
+ *             into component video color space
+ *             int stride: the number of bytes from one element of
+ *             the span to the next
  *             void *cl: a pointer to a Closure struct containing a pointer
  *             to a A2Methods_UArray2 (the destination image in YPbPr_pixel
  *             format) and a pointer to an A2Methods_T struct with function
  *             pointers for operating on the array
  * Returns:    None
- * Expects:    elem to not be NULL and cl points to a Closure struct that
+ * Expects:    base to not be NULL and cl points to a Closure struct that
  *             stores a non-NULL A2Methods_UArray2 and A2Methods_T struct 
  *             and is not NULL
- *             col and row are within the bounds of the array
+ *             the span is within the bounds of the array
  * Notes:      will CRE if cl is NULL or its array or methods field is NULL
- *             will CRE if elem is NULL
- *             If col or row are not valid, the methods->at function will 
- *             throw a CRE
+ *             will CRE if base is NULL
+ *             If the span is out of bounds, A2Span_new will throw
+ *             a CRE
  */
-void unpackBlockApply(int col, int row, A2Methods_UArray2 array2, void *elem,
-                      void *cl)
+void unpackBlockSpan(int col, int row, int count, A2Methods_Object *base,
+                     int stride, void *cl)
 {
-        assert(elem != NULL && cl != NULL);
+        assert(base != NULL && cl != NULL);
 
         struct Closure *closure = cl;
         assert(closure->array != NULL && closure != NULL &&
@@ -270,30 +345,37 @@ void unpackBlockApply(int col, int row, A2Methods_UArray2 array2, void *elem,
         A2Methods_UArray2 destination = closure->array;
         const struct A2Methods_T *methods = closure->methods;
 
-        struct YPbPr_block *currBlock = elem;
-
         col *= BLOCK_SIZE;
         row *= BLOCK_SIZE;
 
-        float Y1;
-        float Y2;
-        float Y3;
-        float Y4;
-
-        DCTtoPixel(currBlock->a, currBlock->b, currBlock->c, currBlock->d, &Y1,
-                   &Y2, &Y3, &Y4);
-
-        struct YPbPr_pixel *pixel1 = methods->at(destination, col, row);
-        struct YPbPr_pixel *pixel2 = methods->at(destination, col + 1, row);
-        struct YPbPr_pixel *pixel3 = methods->at(destination, col, row + 1);
-        struct YPbPr_pixel *pixel4 = methods->at(destination, col + 1, row + 1);
-
-        pixel1->Y = Y1;
-        pixel2->Y = Y2;
-        pixel3->Y = Y3;
-        pixel4->Y = Y4;
-
-        (void) array2;
+        struct A2Span top = A2Span_new(methods, destination, col, row,
+                                       count * BLOCK_SIZE);
+        struct A2Span bottom = A2Span_new(methods, destination, col, row + 1,
+                                          count * BLOCK_SIZE);
+        char *blocks = base;
+
+        for (int i = 0; i < count; i++) {
+                struct YPbPr_block *currBlock =
+                        (struct YPbPr_block *) (blocks + (long) i * stride);
+
+                float Y1;
+                float Y2;
+                float Y3;
+                float Y4;
+
+                DCTtoPixel(currBlock->a, currBlock->b, currBlock->c,
+                           currBlock->d, &Y1, &Y2, &Y3, &Y4);
+
+                struct YPbPr_pixel *pixel1 = A2Span_at(&top, 2 * i);
+                struct YPbPr_pixel *pixel2 = A2Span_at(&top, 2 * i + 1);
+                struct YPbPr_pixel *pixel3 = A2Span_at(&bottom, 2 * i);
+                struct YPbPr_pixel *pixel4 = A2Span_at(&bottom, 2 * i + 1);
+
+                pixel1->Y = Y1;
+                pixel2->Y = Y2;
+                pixel3->Y = Y3;
+                pixel4->Y = Y4;
+        }
 }
 
 /*
@@ -330,48 +412,55 @@ void DCTtoPixel(float a, float b, float c, float d, float *Y1, float *Y2,
 }
 
 /*
- * Name:       setChromaApply
+ * Name:       setChromaSpan
  * Purpose:    Sets the Pb and Pr (chroma) values for each YPbPr_pixel
  *             using the average Pb and Pr values stored in the corresponding
  *             2x2 YPbPr_block from the original compressed image.
- * Parameters: int col: an integer representing the distance between the
- *             current element and the left edge of the array
- *             int row: an integer representing the distance between the
- *             current element and the top of the array
- *             A2Methods_UArray2 array2: required by the A2Methods_Object
- *             interface; ignored here
- *             A2Methods_Object *elem: a pointer to a YPbPr_pixel representing 
- *             the current pixel of the image transformed into component video 
- *             color space
+ * Parameters: int col: the column of the first element of the span
+ *             int row: the row of the span
+ *             int count: the number of elements in the span
+ *             A2Methods_Object *base: a pointer to the first YPbPr_pixel of
+ *             the span, representing pixels of the image transformed into
+ *             component video color space
+ *             int stride: the number of bytes from one element of
+ *             the span to the next
  *             void *cl: a pointer to a Closure struct containing a pointer
  *             to a A2Methods_UArray2 (the original image in YPbPr_pixel
  *             format) and a pointer to an A2Methods_T struct with function
  *             pointers for operating on the array
  * Return:     None
- * Expects:    elem to not be NULL and cl points to a Closure struct that
+ * Expects:    base to not be NULL and cl points to a Closure struct that
  *             stores a non-NULL A2Methods_UArray2 and A2Methods_T struct 
  *             and is not NULL
- *             col and row are within the bounds of the array
+ *             the span is within the bounds of the array
  * Notes:      will CRE if cl is NULL
- *             will CRE if elem is NULL
- *             If col or row are not valid, the methods->at function will 
- *             throw a CRE
+ *             will CRE if base is NULL
+ *             If the span is out of bounds, A2Span_new will throw
+ *             a CRE
  */
-void setChromaApply(int col, int row, A2Methods_UArray2 array2, void *elem,
-                    void *cl)
+void setChromaSpan(int col, int row, int count, A2Methods_Object *base,
+                   int stride, void *cl)
 {
-        assert(elem != NULL && cl != NULL);
+        assert(base != NULL && cl != NULL);
 
         struct Closure *closure = cl;
         A2Methods_UArray2 original = closure->array;
         const struct A2Methods_T *methods = closure->methods;
 
-        struct YPbPr_pixel *currPix = elem;
-        struct YPbPr_block *currBlock =
-                methods->at(original, col / BLOCK_SIZE, row / BLOCK_SIZE);
-
-        currPix->Pb = currBlock->avgPb;
-        currPix->Pr = currBlock->avgPr;
-
-        (void) array2;
+        int firstBlock = col / BLOCK_SIZE;
+        int lastBlock = (col + count - 1) / BLOCK_SIZE;
+        struct A2Span blocks = A2Span_new(methods, original, firstBlock,
+                                          row / BLOCK_SIZE,
+                                          lastBlock - firstBlock + 1);
+        char *pixels = base;
+
+        for (int i = 0; i < count; i++) {
+                struct YPbPr_pixel *currPix =
+                        (struct YPbPr_pixel *) (pixels + (long) i * stride);
+                struct YPbPr_block *currBlock = A2Span_at(
+                        &blocks, (col + i) / BLOCK_SIZE - firstBlock);
+
+                currPix->Pb = currBlock->avgPb;
+                currPix->Pr = currBlock->avgPr;
+        }
 }
\ No newline at end of file
@@ -20,11 +20,11 @@
 
 #include "helpers.h"
 
-A2Methods_UArray2 packBlock(A2Methods_UArray2 original,
-                            const struct A2Methods_T *methods);
+A2Methods_UArray2 rgbToBlock(A2Methods_UArray2 original, unsigned denominator,
+                             const struct A2Methods_T *methods, int threads);
 
-void packBlockApply(int col, int row, A2Methods_UArray2 array2, void *elem,
-                    void *cl);
+void packRgbBlockSpan(int col, int row, int count, A2Methods_Object *base,
+                      int stride, void *cl);
 void averageChroma(struct YPbPr_pixel *p1, struct YPbPr_pixel *p2,
                    struct YPbPr_pixel *p3, struct YPbPr_pixel *p4,
                    struct YPbPr_block *block);
@@ -32,15 +32,15 @@ void pixelToDCT(float Y1, float Y2, float Y3, float Y4,
                 struct YPbPr_block *block);
 
 A2Methods_UArray2 unpackBlock(A2Methods_UArray2 original,
-                              const struct A2Methods_T *methods);
+                              const struct A2Methods_T *methods, int threads);
 
 void DCTtoPixel(float a, float b, float c, float d, float *Y1, float *Y2,
                 float *Y3, float *Y4);
 
-void unpackBlockApply(int col, int row, A2Methods_UArray2 array2, void *elem,
-                      void *cl);
+void unpackBlockSpan(int col, int row, int count, A2Methods_Object *base,
+                     int stride, void *cl);
 
-void setChromaApply(int col, int row, A2Methods_UArray2 array2, void *elem,
-                    void *cl);
+void setChromaSpan(int col, int row, int count, A2Methods_Object *base,
+                   int stride, void *cl);
 
 #endif
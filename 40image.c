@@ -16,11 +16,17 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <errno.h>
 #include "assert.h"
 #include "compress40.h"
+#include "options.h"
+#include "fixedPoint.h"
 
 static void (*compress_or_decompress)(FILE *input) = compress40;
 
+static void usage(const char *program);
+static int parseThreads(const char *program, const char *text);
+
 /************************ main ******************************
  *
  * Reads in user input from the terminal and compresses/decompresses
@@ -34,8 +40,16 @@ static void (*compress_or_decompress)(FILE *input) = compress40;
  *         invalid argument or too many arguments
  *
  * Expects
- *         argc not to be greater than 3. Any flags provided are valid
- *         (-c or -d).
+ *         Any flags provided are valid (-c, -d, --staged, --stream,
+ *         -j followed by a positive number, which is cut down to
+ *         MAX_THREADS, or --region followed by x,y,width,height with a
+ *         positive width and height) and at most one file is given.
+ *         --preview is only used with -d, and not with --region, which -c
+ *         and -d both take. --tiled and --crc are only used with -c, and
+ *         --crc implies --tiled. -o followed by a file name writes the
+ *         result to that file instead of stdout. --fixed and
+ *         --fixed-report (which implies --fixed) are not used with
+ *         --staged.
  * Notes:
  *         May open and close a file provided, may read from stdin
  *
@@ -49,21 +63,69 @@ int main(int argc, char *argv[])
                         compress_or_decompress = compress40;
                 } else if (strcmp(argv[i], "-d") == 0) {
                         compress_or_decompress = decompress40;
+                } else if (strcmp(argv[i], "--staged") == 0) {
+                        codecOptions.staged = true;
+                } else if (strcmp(argv[i], "--tiled") == 0) {
+                        codecOptions.tiled = true;
+                } else if (strcmp(argv[i], "-o") == 0) {
+                        if (i + 1 == argc) {
+                                fprintf(stderr, "%s: -o needs a file name\n",
+                                        argv[0]);
+                                usage(argv[0]);
+                        }
+                        codecOptions.output = argv[++i];
+                } else if (strcmp(argv[i], "--crc") == 0) {
+                        codecOptions.tiled = true;
+                        codecOptions.checksums = true;
+                } else if (strcmp(argv[i], "--fixed") == 0) {
+                        codecOptions.fixedPoint = true;
+                } else if (strcmp(argv[i], "--fixed-report") == 0) {
+                        codecOptions.fixedPoint = true;
+                        codecOptions.fixedReport = true;
+                } else if (strcmp(argv[i], "--preview") == 0) {
+                        codecOptions.preview = true;
+                } else if (strcmp(argv[i], "--stream") == 0) {
+                        codecOptions.stream = true;
+                } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+                        codecOptions.threads = parseThreads(argv[0],
+                                                            argv[++i]);
+                } else if (strcmp(argv[i], "--region") == 0 &&
+                           i + 1 < argc) {
+                        struct Region *region = &codecOptions.region;
+                        char end;
+                        if (sscanf(argv[++i], "%u,%u,%u,%u%c", &region->x,
+                                   &region->y, &region->width,
+                                   &region->height, &end) != 4 ||
+                            region->width == 0 || region->height == 0) {
+                                fprintf(stderr,
+                                        "%s: --region needs x,y,width,height "
+                                        "with a positive width and height\n",
+                                        argv[0]);
+                                exit(1);
+                        }
+                        codecOptions.hasRegion = true;
                 } else if (*argv[i] == '-') {
                         fprintf(stderr, "%s: unknown option '%s'\n", argv[0],
                                 argv[i]);
                         exit(1);
                 } else if (argc - i > 2) {
-                        fprintf(stderr,
-                                "Usage: %s -d [filename]\n"
-                                "       %s -c [filename]\n",
-                                argv[0], argv[0]);
-                        exit(1);
+                        usage(argv[0]);
                 } else {
                         break;
                 }
         }
         assert(argc - i <= 1); /* at most one file on command line */
+        if (codecOptions.preview &&
+            (compress_or_decompress != decompress40 ||
+             codecOptions.hasRegion)) {
+                usage(argv[0]);
+        }
+        if (codecOptions.tiled && compress_or_decompress != compress40) {
+                usage(argv[0]);
+        }
+        if (codecOptions.fixedPoint && codecOptions.staged) {
+                usage(argv[0]);
+        }
         if (i < argc) {
                 FILE *fp = fopen(argv[i], "r");
                 assert(fp != NULL);
@@ -72,6 +134,59 @@ int main(int argc, char *argv[])
         } else {
                 compress_or_decompress(stdin);
         }
+        if (codecOptions.fixedReport) {
+                printFixedReport(stderr);
+        }
 
         return EXIT_SUCCESS;
 }
+
+/*
+ * Name:       usage
+ * Purpose:    Prints how to run the program to stderr and exits
+ * Parameters: const char *program: the name the program was run as
+ * Return:     None; exits with status 1
+ * Expects:    program to not be NULL
+ * Notes:      None
+ */
+static void usage(const char *program)
+{
+        fprintf(stderr,
+                "Usage: %s -d [--staged | --stream | --region x,y,w,h | "
+                "--preview] "
+                "[--fixed | --fixed-report] "
+                "[-j threads] [-o output] [filename]\n"
+                "       %s -c [--staged | --stream | --tiled [--crc]] "
+                "[--region x,y,w,h] "
+                "[--fixed | --fixed-report] "
+                "[-j threads] [-o output] [filename]\n",
+                program, program);
+        exit(1);
+}
+
+/*
+ * Name:       parseThreads
+ * Purpose:    Reads the number of threads given to -j
+ * Parameters: const char *program: the name the program was run as
+ *             const char *text: the argument after -j
+ * Return:     the number of threads, at most MAX_THREADS
+ * Expects:    program and text to not be NULL
+ * Notes:      Prints an error and exits with status 1 if text is not a
+ *             positive decimal number, or is too large for a long.
+ *             A number above MAX_THREADS is cut down to it, so the bands
+ *             and chunks the threads split an image into are always
+ *             counted without overflowing.
+ */
+static int parseThreads(const char *program, const char *text)
+{
+        char *end;
+        errno = 0;
+        long threads = strtol(text, &end, 10);
+        if (end == text || *end != '\0' || errno == ERANGE || threads < 1) {
+                fprintf(stderr, "%s: -j needs a positive number of threads\n",
+                        program);
+                exit(1);
+        }
+
+        return threads > MAX_THREADS ? MAX_THREADS : (int) threads;
+}
@@ -18,6 +18,8 @@
 #include <string.h>
 
 #include <a2blocked.h>
+#include "a2extended.h"
+#include "parallel.h"
 #include "uarray2b.h"
 
 // define a private version of each function in A2Methods_T that we implement
@@ -89,25 +91,167 @@ static void small_map_block_major(A2 a2, A2Methods_smallapplyfun apply,
         UArray2b_map(a2, apply_small, &mycl);
 }
 
-static struct A2Methods_T uarray2_methods_blocked_struct = {
-        new,
-        new_with_blocksize,
-        a2free,
-        width,
-        height,
-        size,
-        blocksize,
-        at,
-        NULL, // map_row_major
-        NULL, // map_col_major
-        map_block_major,
-        map_block_major, // map_default
-        NULL, // small_map_row_major
-        NULL, // small_map_col_major
-        small_map_block_major,
-        small_map_block_major, // small_map_default
+// map_parallel makes each blocksize by blocksize square of the array one
+// task for runParallel(), visiting its cells column by column. The squares
+// start at the array's (0, 0), so for an array from new() they are its
+// blocks, visited in the same order UArray2b_map does. In a view whose
+// corner is not on a block boundary a square spans parts of up to four
+// blocks, and the cells are not visited in UArray2b_map's order.
+
+struct parallel_closure {
+        UArray2b_T array2b;
+        A2Methods_applyfun *apply;
+        void *cl;
+        int xblocks;
+};
+
+static void map_block_task(int block, void *vcl)
+{
+        struct parallel_closure *cl = vcl;
+        int w = UArray2b_width(cl->array2b);
+        int h = UArray2b_height(cl->array2b);
+        int b = UArray2b_blocksize(cl->array2b);
+        int i0 = (block % cl->xblocks) * b;
+        int j0 = (block / cl->xblocks) * b;
+
+        for (int i = i0; i < i0 + b && i < w; i++) {
+                for (int j = j0; j < j0 + b && j < h; j++) {
+                        cl->apply(i, j, cl->array2b,
+                                  UArray2b_at(cl->array2b, i, j), cl->cl);
+                }
+        }
+}
+
+static void map_parallel(A2 array2, int threads, A2Methods_applyfun apply,
+                         void *cl)
+{
+        int b = UArray2b_blocksize(array2);
+        int xblocks = (UArray2b_width(array2) + b - 1) / b;
+        int yblocks = (UArray2b_height(array2) + b - 1) / b;
+
+        struct parallel_closure mycl = { array2, apply, cl, xblocks };
+        runParallel(threads, xblocks * yblocks, map_block_task, &mycl);
+}
+
+static void small_map_parallel(A2 a2, int threads,
+                               A2Methods_smallapplyfun apply, void *cl)
+{
+        struct small_closure mycl = { apply, cl };
+        map_parallel(a2, threads, (A2Methods_applyfun *) apply_small, &mycl);
+}
+
+// span maps hand out the part of one row that lies inside one block, so
+// each span is b cells (fewer at the right edge) that are b * size bytes
+// apart in the block's storage. Blocks are visited in the order they are
+// stored, which is column-major by block (see uarray2b.c). In a view that
+// does not start on a block boundary, a row of a block may lie across two
+// blocks of storage, and is handed out as two spans.
+
+static void map_block_spans(A2 array2, int block, int yblocks,
+                            A2Methods_spanfun apply, void *cl)
+{
+        int w = UArray2b_width(array2);
+        int h = UArray2b_height(array2);
+        int b = UArray2b_blocksize(array2);
+        int i0 = (block / yblocks) * b;
+        int j0 = (block % yblocks) * b;
+        int end = i0 + b < w ? i0 + b : w;
+
+        for (int j = j0; j < j0 + b && j < h; j++) {
+                for (int i = i0; i < end;) {
+                        int count = end - i;
+                        int stride;
+                        void *base = UArray2b_span(array2, i, j, &count,
+                                                   &stride);
+                        apply(i, j, count, base, stride, cl);
+                        i += count;
+                }
+        }
+}
+
+struct span_closure {
+        UArray2b_T array2b;
+        A2Methods_spanfun *apply;
+        void *cl;
+        int yblocks;
+};
+
+static void map_span_task(int block, void *vcl)
+{
+        struct span_closure *cl = vcl;
+        map_block_spans(cl->array2b, block, cl->yblocks, cl->apply, cl->cl);
+}
+
+static void map_spans(A2 array2, A2Methods_spanfun apply, void *cl)
+{
+        int b = UArray2b_blocksize(array2);
+        int xblocks = (UArray2b_width(array2) + b - 1) / b;
+        int yblocks = (UArray2b_height(array2) + b - 1) / b;
+
+        for (int block = 0; block < xblocks * yblocks; block++) {
+                map_block_spans(array2, block, yblocks, apply, cl);
+        }
+}
+
+static void map_spans_parallel(A2 array2, int threads,
+                               A2Methods_spanfun apply, void *cl)
+{
+        int b = UArray2b_blocksize(array2);
+        int xblocks = (UArray2b_width(array2) + b - 1) / b;
+        int yblocks = (UArray2b_height(array2) + b - 1) / b;
+
+        struct span_closure mycl = { array2, apply, cl, yblocks };
+        runParallel(threads, xblocks * yblocks, map_span_task, &mycl);
+}
+
+static A2Methods_Object *span_at(A2 array2, int i, int j, int count,
+                                 int *stride)
+{
+        assert(stride != NULL);
+        assert(count >= 0 && i + count <= UArray2b_width(array2));
+        if (count == 0) {
+                *stride = UArray2b_blocksize(array2) * UArray2b_size(array2);
+                return NULL;
+        }
+
+        int runLength = count;
+        void *base = UArray2b_span(array2, i, j, &runLength, stride);
+        return runLength == count ? base : NULL;
+}
+
+static A2 view(A2 array2, int col, int row, int width, int height)
+{
+        return UArray2b_view(array2, col, row, width, height);
+}
+
+static struct A2Extended_T uarray2_extended_blocked_struct = {
+        {
+                new,
+                new_with_blocksize,
+                a2free,
+                width,
+                height,
+                size,
+                blocksize,
+                at,
+                NULL, // map_row_major
+                NULL, // map_col_major
+                map_block_major,
+                map_block_major, // map_default
+                NULL, // small_map_row_major
+                NULL, // small_map_col_major
+                small_map_block_major,
+                small_map_block_major, // small_map_default
+        },
+        map_parallel,
+        small_map_parallel,
+        map_spans,
+        map_spans_parallel,
+        span_at,
+        view,
 };
 
-// finally the payoff: here is the exported pointer to the struct
+// finally the payoff: here are the exported pointers to the struct
 
-A2Methods_T uarray2_methods_blocked = &uarray2_methods_blocked_struct;
+A2Extended_T uarray2_extended_blocked = &uarray2_extended_blocked_struct;
+A2Methods_T uarray2_methods_blocked = &uarray2_extended_blocked_struct.methods;
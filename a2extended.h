@@ -0,0 +1,186 @@
+/**************************************************************
+ *                     a2extended.h
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the interface for the methods we add on top of
+ *     the course's A2Methods_T suite. a2methods.h belongs to the course
+ *     and is shared with the Pnm library, so instead of changing it, each
+ *     of our suites (a2plain.c and a2blocked.c) stores its A2Methods_T as
+ *     the first member of a bigger A2Extended_T. A pointer to either one
+ *     can be used wherever the other is expected. Along with parallel
+ *     maps, it has span maps, which call a function once per row (or part
+ *     of a row) instead of once per element.
+ *
+ **************************************************************/
+#ifndef A2EXTENDED_H
+#define A2EXTENDED_H
+
+#include <stddef.h>
+
+#include "a2methods.h"
+#include "a2plain.h"
+#include "a2blocked.h"
+#include "assert.h"
+
+/*
+ * A span is a run of elements (col, row), (col + 1, row), ...,
+ * (col + count - 1, row) where element (col + i, row) is stored at
+ * (char *) base + i * stride. A span function is called once per span
+ * instead of once per element, and count is always at least 1.
+ */
+typedef void A2Methods_spanfun(int col, int row, int count,
+                               A2Methods_Object *base, int stride, void *cl);
+typedef void A2Methods_spanmapfun(A2Methods_UArray2 array2,
+                                  A2Methods_spanfun apply, void *cl);
+
+/*
+ * The parallel maps are told how many threads to use by their caller,
+ * counting the calling thread; 1 runs every call on the calling thread.
+ */
+typedef void A2Methods_parallelmapfun(A2Methods_UArray2 array2, int threads,
+                                      A2Methods_applyfun apply, void *cl);
+typedef void A2Methods_smallparallelmapfun(A2Methods_UArray2 array2,
+                                           int threads,
+                                           A2Methods_smallapplyfun apply,
+                                           void *cl);
+typedef void A2Methods_spanparallelmapfun(A2Methods_UArray2 array2,
+                                          int threads,
+                                          A2Methods_spanfun apply, void *cl);
+
+/*
+ * Name:       A2Extended_T
+ * Purpose:    A method suite with everything in A2Methods_T plus the
+ *             methods below
+ * Components: 
+ *             struct A2Methods_T methods: the course's methods. Must stay
+ *             the first member.
+ *             A2Methods_parallelmapfun *map_parallel: calls apply on every
+ *             element like map_default, but splits the elements into
+ *             chunks (rows for a UArray2, blocksize by blocksize squares
+ *             for a UArray2b, which are its blocks unless it is a view)
+ *             that are run on the given number of threads. Chunks are
+ *             handed out one at a time to whichever thread is free, so the
+ *             order of the calls is not defined. apply may only write to
+ *             its own element (or to elements no other call writes) and
+ *             must not depend on the order of the calls.
+ *             A2Methods_smallparallelmapfun *small_map_parallel: the same
+ *             as map_parallel, for small apply functions
+ *             A2Methods_spanmapfun *map_spans: calls apply once for each
+ *             span of the array, covering every element once. A UArray2
+ *             hands out whole rows in row-major order. A UArray2b hands out
+ *             the part of a row inside one block, in block-major order.
+ *             A2Methods_spanparallelmapfun *map_spans_parallel: the same
+ *             as map_spans, with the spans split into chunks that are run
+ *             on the given number of threads, with the same rules as
+ *             map_parallel
+ *             span_at: returns a pointer to element (col, row) and sets
+ *             *stride so that element (col + i, row) is at that pointer plus
+ *             i * *stride for every i less than count. Returns NULL if the
+ *             array does not store those elements that way (a UArray2b span
+ *             that crosses into another block).
+ *             view: returns a new width by height array whose element
+ *             (i, j) is element (col + i, row + j) of array2, without
+ *             copying anything. Every method works on a view. Freeing the
+ *             view with methods->free leaves array2's elements alone, and
+ *             array2 must be freed after its views.
+ */
+typedef const struct A2Extended_T {
+        struct A2Methods_T methods;
+        A2Methods_parallelmapfun *map_parallel;
+        A2Methods_smallparallelmapfun *small_map_parallel;
+        A2Methods_spanmapfun *map_spans;
+        A2Methods_spanparallelmapfun *map_spans_parallel;
+        A2Methods_Object *(*span_at)(A2Methods_UArray2 array2, int col,
+                                     int row, int count, int *stride);
+        A2Methods_UArray2 (*view)(A2Methods_UArray2 array2, int col, int row,
+                                  int width, int height);
+} *A2Extended_T;
+
+/*
+ * Name:       A2Span
+ * Purpose:    Gives fast access to a run of elements of an array that is
+ *             not the one being mapped over
+ * Components: 
+ *             A2Methods_UArray2 array2: the array holding the elements
+ *             const struct A2Methods_T *methods: the methods for array2
+ *             int col, row: the first element of the run
+ *             char *base: what span_at returned for the run
+ *             int stride: the stride span_at gave for the run
+ */
+struct A2Span {
+        A2Methods_UArray2 array2;
+        const struct A2Methods_T *methods;
+        int col, row;
+        char *base;
+        int stride;
+};
+
+extern A2Extended_T uarray2_extended_plain;
+extern A2Extended_T uarray2_extended_blocked;
+
+/*
+ * Name:       A2Extended
+ * Purpose:    Gets the extended methods of one of our method suites
+ * Parameters: const struct A2Methods_T *methods: uarray2_methods_plain or
+ *             uarray2_methods_blocked
+ * Return:     the A2Extended_T that methods is the first member of
+ * Expects:    methods to be one of our two suites
+ * Notes:      will CRE if methods is any other suite
+ */
+static inline A2Extended_T A2Extended(const struct A2Methods_T *methods)
+{
+        assert(methods == uarray2_methods_plain ||
+               methods == uarray2_methods_blocked);
+        return (A2Extended_T) methods;
+}
+
+/*
+ * Name:       A2Span_new
+ * Purpose:    Finds the run of count elements starting at (col, row)
+ * Parameters: const struct A2Methods_T *methods: the methods for array2,
+ *             which must be one of our two suites
+ *             A2Methods_UArray2 array2: the array holding the elements
+ *             int col, row: the first element of the run
+ *             int count: the number of elements in the run
+ * Return:     an A2Span for the run
+ * Expects:    the whole run to be inside array2
+ * Notes:      will CRE if methods is not one of our suites, or if the run
+ *             is not inside array2
+ */
+static inline struct A2Span A2Span_new(const struct A2Methods_T *methods,
+                                       A2Methods_UArray2 array2, int col,
+                                       int row, int count)
+{
+        struct A2Span span = { .array2 = array2, .methods = methods,
+                               .col = col, .row = row };
+        span.base = A2Extended(methods)->span_at(array2, col, row, count,
+                                                 &span.stride);
+        return span;
+}
+
+/*
+ * Name:       A2Span_at
+ * Purpose:    Gets element i of a run
+ * Parameters: const struct A2Span *span: the run
+ *             int i: which element of the run to get
+ * Return:     a pointer to element (col + i, row)
+ * Expects:    span to not be NULL and i to be less than the run's count
+ * Notes:      falls back to methods->at when the run is not stored at a
+ *             constant stride
+ */
+static inline A2Methods_Object *A2Span_at(const struct A2Span *span, int i)
+{
+        if (span->base == NULL) {
+                return span->methods->at(span->array2, span->col + i,
+                                         span->row);
+        }
+        return span->base + (long) i * span->stride;
+}
+
+#endif
@@ -18,6 +18,8 @@
 #include <stdlib.h>
 
 #include <a2plain.h>
+#include "a2extended.h"
+#include "parallel.h"
 #include "uarray2.h"
 
 /*********************************************/
@@ -110,22 +112,162 @@ static void small_map_col_major(A2Methods_UArray2 a2,
         UArray2_map_col_major(a2, apply_small, &mycl);
 }
 
+/*
+ * map_parallel splits the rows into about CHUNKS_PER_THREAD chunks per
+ * thread; each chunk is one task for runParallel()
+ */
+
+static const int CHUNKS_PER_THREAD = 4;
+
+struct parallel_closure {
+        UArray2_T uarray2;
+        A2Methods_applyfun *apply;
+        A2Methods_spanfun *span_apply;
+        void *cl;
+        int rows_per_chunk;
+};
+
+static int chunk_rows(UArray2_T uarray2, int threads)
+{
+        int h = UArray2_height(uarray2);
+        int chunks = threads * CHUNKS_PER_THREAD < h
+                             ? threads * CHUNKS_PER_THREAD
+                             : h;
+        return chunks == 0 ? 0 : (h + chunks - 1) / chunks;
+}
+
+static int chunk_end(struct parallel_closure *cl, int first)
+{
+        int h = UArray2_height(cl->uarray2);
+        return first + cl->rows_per_chunk < h ? first + cl->rows_per_chunk
+                                              : h;
+}
+
+static void map_rows_task(int chunk, void *vcl)
+{
+        struct parallel_closure *cl = vcl;
+        int w = UArray2_width(cl->uarray2);
+        int first = chunk * cl->rows_per_chunk;
+        int last = chunk_end(cl, first);
+
+        int size = UArray2_size(cl->uarray2);
+
+        for (int j = first; j < last; j++) {
+                char *elem = UArray2_row(cl->uarray2, j);
+                for (int i = 0; i < w; i++) {
+                        cl->apply(i, j, cl->uarray2, elem, cl->cl);
+                        elem += size;
+                }
+        }
+}
+
+static void map_parallel(A2Methods_UArray2 uarray2, int threads,
+                         A2Methods_applyfun apply, void *cl)
+{
+        int h = UArray2_height(uarray2);
+        struct parallel_closure mycl = { uarray2, apply, NULL, cl,
+                                         chunk_rows(uarray2, threads) };
+        if (mycl.rows_per_chunk == 0) {
+                return;
+        }
+
+        runParallel(threads,
+                    (h + mycl.rows_per_chunk - 1) / mycl.rows_per_chunk,
+                    map_rows_task, &mycl);
+}
+
+static void small_map_parallel(A2Methods_UArray2 a2, int threads,
+                               A2Methods_smallapplyfun apply, void *cl)
+{
+        struct small_closure mycl = { apply, cl };
+        map_parallel(a2, threads, (A2Methods_applyfun *) apply_small, &mycl);
+}
+
+/*
+ * span maps hand out one whole row at a time; span_at works for any run
+ * inside a row, since rows are stored contiguously
+ */
+
+static void map_spans(A2Methods_UArray2 uarray2, A2Methods_spanfun apply,
+                      void *cl)
+{
+        int w = UArray2_width(uarray2);
+        int h = UArray2_height(uarray2);
+        int size = UArray2_size(uarray2);
+        if (w == 0) {
+                return;
+        }
+
+        for (int j = 0; j < h; j++) {
+                apply(0, j, w, UArray2_row(uarray2, j), size, cl);
+        }
+}
+
+static void map_span_rows_task(int chunk, void *vcl)
+{
+        struct parallel_closure *cl = vcl;
+        int w = UArray2_width(cl->uarray2);
+        int size = UArray2_size(cl->uarray2);
+        int first = chunk * cl->rows_per_chunk;
+        int last = chunk_end(cl, first);
+
+        for (int j = first; j < last; j++) {
+                cl->span_apply(0, j, w, UArray2_row(cl->uarray2, j), size,
+                               cl->cl);
+        }
+}
+
+static void map_spans_parallel(A2Methods_UArray2 uarray2, int threads,
+                               A2Methods_spanfun apply, void *cl)
+{
+        int h = UArray2_height(uarray2);
+        struct parallel_closure mycl = { uarray2, NULL, apply, cl,
+                                         chunk_rows(uarray2, threads) };
+        if (mycl.rows_per_chunk == 0 || UArray2_width(uarray2) == 0) {
+                return;
+        }
+
+        runParallel(threads,
+                    (h + mycl.rows_per_chunk - 1) / mycl.rows_per_chunk,
+                    map_span_rows_task, &mycl);
+}
+
+static A2Methods_Object *span_at(A2Methods_UArray2 uarray2, int i, int j,
+                                 int count, int *stride)
+{
+        assert(stride != NULL);
+        assert(count >= 0 && i + count <= UArray2_width(uarray2));
+        *stride = UArray2_size(uarray2);
+        return UArray2_at(uarray2, i, j);
+}
+
+static A2Methods_UArray2 view(A2Methods_UArray2 uarray2, int col, int row,
+                              int width, int height)
+{
+        return UArray2_view(uarray2, col, row, width, height);
+}
+
 /*
  * now create the private struct containing pointers to the functions
  */
 
-static struct A2Methods_T uarray2_methods_plain_struct = {
-        new, new_with_blocksize,
-        /* ... other functions follow in order, 
-               with NULL for those not implemented ...
-        */
-        a2free, width, height, size, blocksize, at, map_row_major,
-        map_col_major, NULL, map_row_major, small_map_row_major,
-        small_map_col_major, NULL, small_map_row_major
+static struct A2Extended_T uarray2_extended_plain_struct = {
+        {
+                new, new_with_blocksize,
+                /* ... other functions follow in order, 
+                       with NULL for those not implemented ...
+                */
+                a2free, width, height, size, blocksize, at, map_row_major,
+                map_col_major, NULL, map_row_major, small_map_row_major,
+                small_map_col_major, NULL, small_map_row_major
+        },
+        map_parallel, small_map_parallel, map_spans, map_spans_parallel,
+        span_at, view
 };
 
 /* 
- * finally the payoff: here is the exported pointer to the struct
+ * finally the payoff: here are the exported pointers to the struct
  */
 
-A2Methods_T uarray2_methods_plain = &uarray2_methods_plain_struct;
+A2Extended_T uarray2_extended_plain = &uarray2_extended_plain_struct;
+A2Methods_T uarray2_methods_plain = &uarray2_extended_plain_struct.methods;
@@ -0,0 +1,358 @@
+/**************************************************************
+ *                     a2test.c
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file tests the views and spans of both of our method suites
+ *     (a2plain.c and a2blocked.c), and is run by "make check". It fills
+ *     an array whose size is not a multiple of the blocksize with the
+ *     coordinates of each element, then checks that every method finds
+ *     the right elements of views at block-aligned and unaligned corners,
+ *     and of a view of a view. Prints one line per failed check and exits
+ *     with status 1 if any failed.
+ *
+ **************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "a2methods.h"
+#include "a2extended.h"
+#include "assert.h"
+
+enum { WIDTH = 23, HEIGHT = 19, BLOCKSIZE = 4, THREADS = 3 };
+
+/*
+ * Name:       View
+ * Purpose:    Where a view lies in the array it is made from
+ * Components:
+ *             int col, row: the element of the parent at the view's (0, 0)
+ *             int width, height: the size of the view
+ */
+struct View {
+        int col, row;
+        int width, height;
+};
+
+/*
+ * Name:       Visit_closure
+ * Purpose:    Records which elements of a view a map handed out
+ * Components:
+ *             struct View view: the view being mapped over, in the
+ *             coordinates of the filled array
+ *             int *visits: one count per element of the view, row-major.
+ *             A visit adds 1 if the element holds the right value and
+ *             WRONG if it does not, so each count must end up 1.
+ */
+struct Visit_closure {
+        struct View view;
+        int *visits;
+};
+
+/* added to a visit count for an element that holds the wrong value */
+enum { WRONG = 1000 };
+
+static int failures = 0;
+
+static void fail(const char *suite, struct View view, const char *what);
+static int value(int col, int row);
+static void fill(int i, int j, A2Methods_UArray2 array2,
+                 A2Methods_Object *elem, void *cl);
+static void visit(struct Visit_closure *cl, int i, int j, int *elem);
+static void visitElement(int i, int j, A2Methods_UArray2 array2,
+                         A2Methods_Object *elem, void *cl);
+static void visitSpan(int col, int row, int count, A2Methods_Object *base,
+                      int stride, void *cl);
+static void checkVisits(const char *suite, struct View view,
+                        struct Visit_closure *cl, const char *what);
+static void checkView(const char *suite, A2Methods_T methods,
+                      A2Methods_UArray2 array2, A2Methods_UArray2 view,
+                      struct View where);
+static void testSuite(const char *suite, A2Methods_T methods);
+
+/************************ main ******************************
+ *
+ * Tests the views and spans of the plain and blocked method suites
+ *
+ * Parameters:
+ *         None
+ *
+ * Return: EXIT_SUCCESS if every check passed, EXIT_FAILURE if not
+ *
+ * Expects
+ *         None
+ * Notes:
+ *         Prints a line to stdout for each failed check
+ *
+ ************************************************************/
+int main(void)
+{
+        testSuite("plain", uarray2_methods_plain);
+        testSuite("blocked", uarray2_methods_blocked);
+
+        if (failures != 0) {
+                printf("%d a2test checks failed\n", failures);
+                return EXIT_FAILURE;
+        }
+        printf("all a2test checks passed\n");
+        return EXIT_SUCCESS;
+}
+
+/*
+ * Name:       testSuite
+ * Purpose:    Checks the views of one method suite
+ * Parameters: const char *suite: the name of the suite, for messages
+ *             A2Methods_T methods: the suite to test
+ * Return:     None
+ * Expects:    methods to be one of our two suites
+ * Notes:      Allocates and frees a WIDTH by HEIGHT array of ints and its
+ *             views. The views cover the whole array, corners on and off
+ *             a block boundary, a single element at the far corner, and a
+ *             view made from another view.
+ */
+static void testSuite(const char *suite, A2Methods_T methods)
+{
+        static const struct View views[] = {
+                { 0, 0, WIDTH, HEIGHT },
+                { 4, 8, 8, 4 },
+                { 5, 3, 10, 9 },
+                { 3, 1, WIDTH - 3, HEIGHT - 1 },
+                { WIDTH - 1, HEIGHT - 1, 1, 1 }
+        };
+        A2Extended_T extended = A2Extended(methods);
+        A2Methods_UArray2 array2 = methods->new_with_blocksize(
+                WIDTH, HEIGHT, sizeof(int), BLOCKSIZE);
+        methods->map_default(array2, fill, NULL);
+
+        for (size_t v = 0; v < sizeof(views) / sizeof(views[0]); v++) {
+                struct View where = views[v];
+                A2Methods_UArray2 view =
+                        extended->view(array2, where.col, where.row,
+                                       where.width, where.height);
+                checkView(suite, methods, array2, view, where);
+                methods->free(&view);
+        }
+
+        /* (2, 1) of a view whose corner is (5, 3) is (7, 4) of array2 */
+        A2Methods_UArray2 outer = extended->view(array2, 5, 3, 10, 9);
+        A2Methods_UArray2 inner = extended->view(outer, 2, 1, 6, 6);
+        checkView(suite, methods, array2, inner,
+                  (struct View) { 7, 4, 6, 6 });
+        methods->free(&inner);
+        methods->free(&outer);
+
+        methods->free(&array2);
+}
+
+/*
+ * Name:       checkView
+ * Purpose:    Checks that every method finds the right elements of a view
+ * Parameters: const char *suite: the name of the suite, for messages
+ *             A2Methods_T methods: the suite view belongs to
+ *             A2Methods_UArray2 array2: the array filled by fill()
+ *             A2Methods_UArray2 view: the view to check
+ *             struct View where: where view lies in array2
+ * Return:     None
+ * Expects:    methods to be one of our two suites and view to be a view of
+ *             array2, or of a view of it
+ * Notes:      Checks the size, at, every map (sequential, parallel, and by
+ *             spans), span_at on every row, and that writing through the
+ *             view changes the array it was made from.
+ *             Allocates and frees one visit count per element.
+ */
+static void checkView(const char *suite, A2Methods_T methods,
+                      A2Methods_UArray2 array2, A2Methods_UArray2 view,
+                      struct View where)
+{
+        A2Extended_T extended = A2Extended(methods);
+        if (methods->width(view) != where.width ||
+            methods->height(view) != where.height ||
+            methods->size(view) != (int) sizeof(int)) {
+                fail(suite, where, "size");
+                return;
+        }
+
+        for (int j = 0; j < where.height; j++) {
+                for (int i = 0; i < where.width; i++) {
+                        if (*(int *) methods->at(view, i, j) !=
+                            value(where.col + i, where.row + j)) {
+                                fail(suite, where, "at");
+                                return;
+                        }
+                }
+        }
+
+        struct Visit_closure cl = { where, NULL };
+        cl.visits = calloc((size_t) where.width * where.height, sizeof(int));
+        assert(cl.visits != NULL);
+
+        methods->map_default(view, visitElement, &cl);
+        checkVisits(suite, where, &cl, "map_default");
+        extended->map_parallel(view, THREADS, visitElement, &cl);
+        checkVisits(suite, where, &cl, "map_parallel");
+        extended->map_spans(view, visitSpan, &cl);
+        checkVisits(suite, where, &cl, "map_spans");
+        extended->map_spans_parallel(view, THREADS, visitSpan, &cl);
+        checkVisits(suite, where, &cl, "map_spans_parallel");
+
+        /* a whole row, which span_at may only hand out for a plain view */
+        for (int j = 0; j < where.height; j++) {
+                struct A2Span span =
+                        A2Span_new(methods, view, 0, j, where.width);
+                for (int i = 0; i < where.width; i++) {
+                        visit(&cl, i, j, (int *) A2Span_at(&span, i));
+                }
+        }
+        checkVisits(suite, where, &cl, "span_at");
+
+        int *corner = methods->at(view, 0, 0);
+        *corner = -1;
+        if (*(int *) methods->at(array2, where.col, where.row) != -1) {
+                fail(suite, where, "writing through the view");
+        }
+        *corner = value(where.col, where.row);
+
+        free(cl.visits);
+}
+
+/*
+ * Name:       fill
+ * Purpose:    Stores the value of an element's coordinates in it
+ * Parameters: int i, j: the column and row of the element
+ *             A2Methods_UArray2 array2: the array being filled (unused)
+ *             A2Methods_Object *elem: the int to fill
+ *             void *cl: unused
+ * Return:     None
+ * Expects:    elem to not be NULL
+ * Notes:      Meant to be passed to map_default
+ */
+static void fill(int i, int j, A2Methods_UArray2 array2,
+                 A2Methods_Object *elem, void *cl)
+{
+        (void) array2;
+        (void) cl;
+        *(int *) elem = value(i, j);
+}
+
+/*
+ * Name:       value
+ * Purpose:    Gets the value fill() stores in an element
+ * Parameters: int col, row: the element's coordinates in the filled array
+ * Return:     a value no other element of the array holds
+ * Expects:    col to be less than 1000
+ * Notes:      None
+ */
+static int value(int col, int row)
+{
+        return row * 1000 + col;
+}
+
+/*
+ * Name:       visit
+ * Purpose:    Counts a visit to an element of a view
+ * Parameters: struct Visit_closure *cl: the view and its visit counts
+ *             int i, j: the element's coordinates in the view
+ *             int *elem: what the method handed out for (i, j)
+ * Return:     None
+ * Expects:    cl and elem to not be NULL
+ * Notes:      Adds WRONG instead of 1 if (i, j) is outside the view or elem
+ *             does not hold (i, j)'s value. Each call writes only (i, j)'s
+ *             count, so the parallel maps can call it from any thread.
+ */
+static void visit(struct Visit_closure *cl, int i, int j, int *elem)
+{
+        struct View *view = &cl->view;
+        if (i < 0 || j < 0 || i >= view->width || j >= view->height) {
+                cl->visits[0] += WRONG;
+                return;
+        }
+
+        int right = *elem == value(view->col + i, view->row + j);
+        cl->visits[j * view->width + i] += right ? 1 : WRONG;
+}
+
+/*
+ * Name:       visitElement
+ * Purpose:    Counts a visit from map_default or map_parallel
+ * Parameters: int i, j: the column and row of the element
+ *             A2Methods_UArray2 array2: the view being mapped (unused)
+ *             A2Methods_Object *elem: the element
+ *             void *cl: a struct Visit_closure
+ * Return:     None
+ * Expects:    elem and cl to not be NULL
+ * Notes:      None
+ */
+static void visitElement(int i, int j, A2Methods_UArray2 array2,
+                         A2Methods_Object *elem, void *cl)
+{
+        (void) array2;
+        visit(cl, i, j, elem);
+}
+
+/*
+ * Name:       visitSpan
+ * Purpose:    Counts a visit to every element of a span from map_spans or
+ *             map_spans_parallel
+ * Parameters: int col, row: the first element of the span
+ *             int count: the number of elements in the span
+ *             A2Methods_Object *base: the first element
+ *             int stride: the bytes from one element to the next
+ *             void *cl: a struct Visit_closure
+ * Return:     None
+ * Expects:    base and cl to not be NULL
+ * Notes:      None
+ */
+static void visitSpan(int col, int row, int count, A2Methods_Object *base,
+                      int stride, void *cl)
+{
+        for (int i = 0; i < count; i++) {
+                visit(cl, col + i, row,
+                      (int *) ((char *) base + (long) i * stride));
+        }
+}
+
+/*
+ * Name:       checkVisits
+ * Purpose:    Checks that a map visited every element of a view once, and
+ *             clears the counts for the next one
+ * Parameters: const char *suite: the name of the suite, for messages
+ *             struct View view: the view that was mapped, for messages
+ *             struct Visit_closure *cl: the visit counts
+ *             const char *what: the method that did the visiting
+ * Return:     None
+ * Expects:    cl to not be NULL
+ * Notes:      None
+ */
+static void checkVisits(const char *suite, struct View view,
+                        struct Visit_closure *cl, const char *what)
+{
+        int cells = view.width * view.height;
+        int wrong = 0;
+        for (int i = 0; i < cells; i++) {
+                wrong += cl->visits[i] != 1;
+                cl->visits[i] = 0;
+        }
+        if (wrong != 0) {
+                fail(suite, view, what);
+        }
+}
+
+/*
+ * Name:       fail
+ * Purpose:    Records a failed check and prints which one it was
+ * Parameters: const char *suite: the name of the suite
+ *             struct View view: the view being checked
+ *             const char *what: the method that failed
+ * Return:     None
+ * Expects:    suite and what to not be NULL
+ * Notes:      None
+ */
+static void fail(const char *suite, struct View view, const char *what)
+{
+        printf("FAIL: %s view at %d,%d of %dx%d: %s\n", suite, view.col,
+               view.row, view.width, view.height, what);
+        failures++;
+}
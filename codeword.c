@@ -0,0 +1,314 @@
+/**************************************************************
+ *                     codeword.c
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the fused compression and decompression kernels.
+ *     They run every step of the staged pipeline (color conversion, 2x2
+ *     packing, quantization, and bitpacking) on a single 2x2 block at a
+ *     time, so a code word can be produced or decoded without allocating
+ *     the intermediate arrays. They reuse the per-block helpers of each
+ *     stage, so with the float engine the results are identical to the
+ *     staged pipeline's. The fixed-point engine (--fixed) may differ from
+ *     them by a rounding step in a field or byte.
+ *
+ **************************************************************/
+#include "codeword.h"
+#include "convertColor.h"
+#include "colorKernel.h"
+#include "colorTable.h"
+#include "fixedPoint.h"
+#include "2x2pack.h"
+#include "quantize.h"
+#include "packWord.h"
+#include "assert.h"
+
+/*
+ * Name:       optionsEngine
+ * Purpose:    Finds the engine a set of options asks for
+ * Parameters: const struct Options *options: the options
+ * Return:     ENGINE_FIXED_CHECKED if options->fixedReport is set,
+ *             ENGINE_FIXED if only options->fixedPoint is, and ENGINE_FLOAT
+ *             otherwise
+ * Expects:    options to not be NULL
+ * Notes:      will CRE if options is NULL
+ *             called once by each path of compress40() and decompress40(),
+ *             which pass the result down to the row functions below
+ */
+enum Engine optionsEngine(const struct Options *options)
+{
+        assert(options != NULL);
+        if (options->fixedReport) {
+                return ENGINE_FIXED_CHECKED;
+        }
+        return options->fixedPoint ? ENGINE_FIXED : ENGINE_FLOAT;
+}
+
+/*
+ * Name:       rgbToWord
+ * Purpose:    Compresses one 2x2 block of pixels in RGB color space into
+ *             its 32-bit code word
+ * Parameters: Pnm_rgb pixel1: the top left pixel of the block
+ *             Pnm_rgb pixel2: the top right pixel of the block
+ *             Pnm_rgb pixel3: the bottom left pixel of the block
+ *             Pnm_rgb pixel4: the bottom right pixel of the block
+ *             unsigned denominator: an unsigned integer representing the
+ *             maximum color value of the PPM
+ * Return:     a 32-bit code word representing the block
+ * Expects:    the four pixels to not be NULL
+ * Notes:      will CRE if any of the pixels are NULL
+ */
+uint32_t rgbToWord(Pnm_rgb pixel1, Pnm_rgb pixel2, Pnm_rgb pixel3,
+                   Pnm_rgb pixel4, unsigned denominator)
+{
+        assert(pixel1 != NULL && pixel2 != NULL);
+        assert(pixel3 != NULL && pixel4 != NULL);
+
+        const struct Color_table *table = colorTable(denominator);
+        struct YPbPr_pixel Y1 = tableToYPbPr(table, pixel1);
+        struct YPbPr_pixel Y2 = tableToYPbPr(table, pixel2);
+        struct YPbPr_pixel Y3 = tableToYPbPr(table, pixel3);
+        struct YPbPr_pixel Y4 = tableToYPbPr(table, pixel4);
+
+        return YPbPrToWord(&Y1, &Y2, &Y3, &Y4);
+}
+
+/*
+ * Name:       YPbPrToWord
+ * Purpose:    Compresses one 2x2 block of pixels already in component
+ *             video color space into its 32-bit code word
+ * Parameters: struct YPbPr_pixel *pixel1: the top left pixel of the block
+ *             struct YPbPr_pixel *pixel2: the top right pixel of the block
+ *             struct YPbPr_pixel *pixel3: the bottom left pixel of the block
+ *             struct YPbPr_pixel *pixel4: the bottom right pixel of the
+ *             block
+ * Return:     a 32-bit code word representing the block
+ * Expects:    the four pixels to not be NULL
+ * Notes:      will CRE if any of the pixels are NULL
+ */
+uint32_t YPbPrToWord(struct YPbPr_pixel *pixel1, struct YPbPr_pixel *pixel2,
+                     struct YPbPr_pixel *pixel3, struct YPbPr_pixel *pixel4)
+{
+        assert(pixel1 != NULL && pixel2 != NULL);
+        assert(pixel3 != NULL && pixel4 != NULL);
+
+        struct YPbPr_block block;
+        averageChroma(pixel1, pixel2, pixel3, pixel4, &block);
+        pixelToDCT(pixel1->Y, pixel2->Y, pixel3->Y, pixel4->Y, &block);
+
+        struct Quantized_Block quantized;
+        quantizeBlock(&block, &quantized);
+
+        return bitpackWord(quantized.a, quantized.b, quantized.c, quantized.d,
+                           quantized.avgPb, quantized.avgPr);
+}
+
+/*
+ * Name:       rgbRowsToWords
+ * Purpose:    Compresses a row of 2x2 blocks, given the two rows of pixels
+ *             they cover, into their code words
+ * Parameters: const struct Pnm_rgb *top: the top row of pixels
+ *             const struct Pnm_rgb *bottom: the bottom row of pixels
+ *             unsigned count: the number of blocks, half the pixels in a row
+ *             unsigned denominator: an unsigned integer representing the
+ *             maximum color value of the PPM
+ *             struct YPbPr_pixel *converted: room for 4 * count pixels,
+ *             which the rows are converted into first
+ *             uint32_t *words: where the count code words are stored
+ *             enum Engine engine: the arithmetic to use
+ * Return:     None
+ * Expects:    top, bottom, converted, and words to not be NULL
+ * Notes:      will CRE if any of them are NULL
+ *             Gives the same code words as rgbToWord() on each block, but
+ *             converts the color of each whole row with rgbRowToYPbPr()
+ *             Uses fixedRowsToWords() instead if engine is not
+ *             ENGINE_FLOAT, checking it if engine is ENGINE_FIXED_CHECKED
+ */
+void rgbRowsToWords(const struct Pnm_rgb *top, const struct Pnm_rgb *bottom,
+                    unsigned count, unsigned denominator,
+                    struct YPbPr_pixel *converted, uint32_t *words,
+                    enum Engine engine)
+{
+        assert(top != NULL && bottom != NULL);
+        assert(converted != NULL && words != NULL);
+
+        if (engine != ENGINE_FLOAT) {
+                fixedRowsToWords(top, bottom, count, denominator, words);
+                if (engine == ENGINE_FIXED_CHECKED) {
+                        checkFixedWords(top, bottom, count, denominator,
+                                        words);
+                }
+                return;
+        }
+
+        struct YPbPr_pixel *upper = converted;
+        struct YPbPr_pixel *lower = converted + 2 * count;
+        rgbRowToYPbPr(top, upper, 2 * count, denominator);
+        rgbRowToYPbPr(bottom, lower, 2 * count, denominator);
+
+        for (unsigned i = 0; i < count; i++) {
+                words[i] = YPbPrToWord(&upper[2 * i], &upper[2 * i + 1],
+                                       &lower[2 * i], &lower[2 * i + 1]);
+        }
+}
+
+/*
+ * Name:       wordToRGB
+ * Purpose:    Decompresses one 32-bit code word into the 2x2 block of
+ *             pixels in RGB color space it represents
+ * Parameters: uint32_t word: the code word to decompress
+ *             unsigned denominator: an unsigned integer representing the
+ *             maximum color value of the decompressed PPM
+ *             Pnm_rgb pixel1: where the top left pixel is stored
+ *             Pnm_rgb pixel2: where the top right pixel is stored
+ *             Pnm_rgb pixel3: where the bottom left pixel is stored
+ *             Pnm_rgb pixel4: where the bottom right pixel is stored
+ * Return:     None
+ * Expects:    the four pixels to not be NULL
+ * Notes:      will CRE if any of the pixels are NULL
+ */
+void wordToRGB(uint32_t word, unsigned denominator, Pnm_rgb pixel1,
+               Pnm_rgb pixel2, Pnm_rgb pixel3, Pnm_rgb pixel4)
+{
+        assert(pixel1 != NULL && pixel2 != NULL);
+        assert(pixel3 != NULL && pixel4 != NULL);
+
+        struct YPbPr_pixel Y1, Y2, Y3, Y4;
+        wordToYPbPr(word, &Y1, &Y2, &Y3, &Y4);
+
+        *pixel1 = pixelToRGB(&Y1, denominator);
+        *pixel2 = pixelToRGB(&Y2, denominator);
+        *pixel3 = pixelToRGB(&Y3, denominator);
+        *pixel4 = pixelToRGB(&Y4, denominator);
+}
+
+/*
+ * Name:       wordToYPbPr
+ * Purpose:    Decompresses one 32-bit code word into the 2x2 block of
+ *             pixels in component video color space it represents
+ * Parameters: uint32_t word: the code word to decompress
+ *             struct YPbPr_pixel *pixel1: where the top left pixel is
+ *             stored
+ *             struct YPbPr_pixel *pixel2: where the top right pixel is
+ *             stored
+ *             struct YPbPr_pixel *pixel3: where the bottom left pixel is
+ *             stored
+ *             struct YPbPr_pixel *pixel4: where the bottom right pixel is
+ *             stored
+ * Return:     None
+ * Expects:    the four pixels to not be NULL
+ * Notes:      will CRE if any of the pixels are NULL
+ */
+void wordToYPbPr(uint32_t word, struct YPbPr_pixel *pixel1,
+                 struct YPbPr_pixel *pixel2, struct YPbPr_pixel *pixel3,
+                 struct YPbPr_pixel *pixel4)
+{
+        assert(pixel1 != NULL && pixel2 != NULL);
+        assert(pixel3 != NULL && pixel4 != NULL);
+
+        struct Quantized_Block quantized;
+        unbitpackWord(word, &quantized.a, &quantized.b, &quantized.c,
+                      &quantized.d, &quantized.avgPb, &quantized.avgPr);
+
+        struct YPbPr_block block;
+        dequantizeBlock(&quantized, &block);
+
+        pixel1->Pb = pixel2->Pb = pixel3->Pb = pixel4->Pb = block.avgPb;
+        pixel1->Pr = pixel2->Pr = pixel3->Pr = pixel4->Pr = block.avgPr;
+        DCTtoPixel(block.a, block.b, block.c, block.d, &pixel1->Y,
+                   &pixel2->Y, &pixel3->Y, &pixel4->Y);
+}
+
+/*
+ * Name:       wordsToBytes
+ * Purpose:    Decompresses a row of code words straight into the bytes a
+ *             raw PPM with a maximum color value of 255 stores for the two
+ *             rows of pixels they cover
+ * Parameters: const uint32_t *words: the code words to decompress
+ *             unsigned count: the number of code words
+ *             struct YPbPr_pixel *converted: room for 4 * count pixels,
+ *             which the code words are decompressed into first
+ *             unsigned char *top: where the 6 * count bytes of the top row
+ *             are stored
+ *             unsigned char *bottom: where the 6 * count bytes of the
+ *             bottom row are stored
+ *             enum Engine engine: the arithmetic to use
+ * Return:     None
+ * Expects:    words, converted, top, and bottom to not be NULL
+ * Notes:      will CRE if any of them are NULL
+ *             Each row is turned into bytes at once by YPbPrRowToBytes()
+ *             Uses fixedWordsToBytes() instead if engine is not
+ *             ENGINE_FLOAT, checking it if engine is ENGINE_FIXED_CHECKED
+ */
+void wordsToBytes(const uint32_t *words, unsigned count,
+                  struct YPbPr_pixel *converted, unsigned char *top,
+                  unsigned char *bottom, enum Engine engine)
+{
+        assert(words != NULL && converted != NULL);
+        assert(top != NULL && bottom != NULL);
+
+        if (engine != ENGINE_FLOAT) {
+                fixedWordsToBytes(words, count, top, bottom);
+                if (engine == ENGINE_FIXED_CHECKED) {
+                        checkFixedBytes(words, count, top, bottom);
+                }
+                return;
+        }
+
+        struct YPbPr_pixel *upper = converted;
+        struct YPbPr_pixel *lower = converted + 2 * count;
+        for (unsigned i = 0; i < count; i++) {
+                wordToYPbPr(words[i], &upper[2 * i], &upper[2 * i + 1],
+                            &lower[2 * i], &lower[2 * i + 1]);
+        }
+
+        YPbPrRowToBytes(upper, top, 2 * count);
+        YPbPrRowToBytes(lower, bottom, 2 * count);
+}
+
+/*
+ * Name:       wordsToPreviewBytes
+ * Purpose:    Decompresses a row of code words into a row of a
+ *             half-resolution preview: one pixel per code word, the mean
+ *             color of its 2x2 block
+ * Parameters: const uint32_t *words: the code words to decompress
+ *             unsigned count: the number of code words
+ *             struct YPbPr_pixel *converted: room for count pixels, which
+ *             the code words are decompressed into first
+ *             unsigned char *pixels: where the 3 * count bytes are stored,
+ *             as a raw PPM with a maximum color value of 255 stores them
+ *             enum Engine engine: the arithmetic to use
+ * Return:     None
+ * Expects:    words, converted, and pixels to not be NULL
+ * Notes:      will CRE if any of them are NULL
+ *             Only a, avgPb, and avgPr are unpacked and dequantized, and
+ *             the inverse DCT is skipped
+ *             Uses fixedWordsToPreviewBytes() instead if engine is not
+ *             ENGINE_FLOAT, checking it if engine is ENGINE_FIXED_CHECKED
+ */
+void wordsToPreviewBytes(const uint32_t *words, unsigned count,
+                         struct YPbPr_pixel *converted, unsigned char *pixels,
+                         enum Engine engine)
+{
+        assert(words != NULL && converted != NULL && pixels != NULL);
+        if (engine != ENGINE_FLOAT) {
+                fixedWordsToPreviewBytes(words, count, pixels);
+                if (engine == ENGINE_FIXED_CHECKED) {
+                        checkFixedPreview(words, count, pixels);
+                }
+                return;
+        }
+
+        for (unsigned i = 0; i < count; i++) {
+                unsigned a, avgPb, avgPr;
+                unbitpackMean(words[i], &a, &avgPb, &avgPr);
+                dequantizeMean(a, avgPb, avgPr, &converted[i]);
+        }
+
+        YPbPrRowToBytes(converted, pixels, count);
+}
@@ -0,0 +1,59 @@
+/**************************************************************
+ *                     codeword.h
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the function declarations for codeword.c.
+ *     These functions turn a 2x2 block of RGB pixels straight into its
+ *     32-bit code word (and back) without storing any intermediate image.
+ *
+ **************************************************************/
+#ifndef CODEWORD_H
+#define CODEWORD_H
+
+#include <stdint.h>
+#include "pnm.h"
+#include "helpers.h"
+#include "options.h"
+
+/*
+ * Name:       Engine
+ * Purpose:    Selects the arithmetic that rgbRowsToWords(), wordsToBytes(),
+ *             and wordsToPreviewBytes() use
+ * Values:
+ *             ENGINE_FLOAT: the float engine, the one every other path
+ *             matches
+ *             ENGINE_FIXED: the fixed-point engine of fixedPoint.c
+ *             ENGINE_FIXED_CHECKED: the fixed-point engine, with every row
+ *             checked against the float engine for printFixedReport()
+ */
+enum Engine { ENGINE_FLOAT, ENGINE_FIXED, ENGINE_FIXED_CHECKED };
+
+enum Engine optionsEngine(const struct Options *options);
+
+uint32_t rgbToWord(Pnm_rgb pixel1, Pnm_rgb pixel2, Pnm_rgb pixel3,
+                   Pnm_rgb pixel4, unsigned denominator);
+uint32_t YPbPrToWord(struct YPbPr_pixel *pixel1, struct YPbPr_pixel *pixel2,
+                     struct YPbPr_pixel *pixel3, struct YPbPr_pixel *pixel4);
+void rgbRowsToWords(const struct Pnm_rgb *top, const struct Pnm_rgb *bottom,
+                    unsigned count, unsigned denominator,
+                    struct YPbPr_pixel *converted, uint32_t *words,
+                    enum Engine engine);
+void wordToRGB(uint32_t word, unsigned denominator, Pnm_rgb pixel1,
+               Pnm_rgb pixel2, Pnm_rgb pixel3, Pnm_rgb pixel4);
+void wordToYPbPr(uint32_t word, struct YPbPr_pixel *pixel1,
+                 struct YPbPr_pixel *pixel2, struct YPbPr_pixel *pixel3,
+                 struct YPbPr_pixel *pixel4);
+void wordsToBytes(const uint32_t *words, unsigned count,
+                  struct YPbPr_pixel *converted, unsigned char *top,
+                  unsigned char *bottom, enum Engine engine);
+void wordsToPreviewBytes(const uint32_t *words, unsigned count,
+                         struct YPbPr_pixel *converted, unsigned char *pixels,
+                         enum Engine engine);
+
+#endif
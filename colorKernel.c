@@ -0,0 +1,764 @@
+/**************************************************************
+ *                     colorKernel.c
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the implementations for rgbRowToYPbPr(),
+ *     YPbPrRowToRGB(), and YPbPrRowToBytes(). On x86-64 processors a row
+ *     is converted 8 pixels per step with AVX2, or with SSE4.1 on
+ *     processors without it; everywhere else, and for the last few pixels
+ *     of a row, the tables of colorTable.c and pixelToRGB() are used.
+ *     Which one to use is decided once, the first time a row is converted.
+ *
+ *     pixelToYPbPr() and pixelToRGB() work in float but multiply by their
+ *     double coefficients in double, so the vector code does the same, in
+ *     the same order and without fused multiply-adds, which keeps its
+ *     results bit-for-bit the same.
+ *
+ **************************************************************/
+#include "colorKernel.h"
+#include "convertColor.h"
+#include "colorTable.h"
+#include <pthread.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define HAVE_VECTOR_KERNELS 1
+#include <immintrin.h>
+#endif
+
+typedef void Ypbpr_rowfun(const struct Pnm_rgb *pixels,
+                          struct YPbPr_pixel *out, int count,
+                          unsigned denominator);
+typedef void Rgb_rowfun(const struct YPbPr_pixel *pixels,
+                        struct Pnm_rgb *out, int count, unsigned denominator);
+typedef void Bytes_rowfun(const struct YPbPr_pixel *pixels,
+                          unsigned char *out, int count);
+
+static Ypbpr_rowfun *toYPbPr;
+static Rgb_rowfun *toRGB;
+static Bytes_rowfun *toBytes;
+static pthread_once_t setupOnce = PTHREAD_ONCE_INIT;
+
+static void setup(void);
+static void scalarRowToYPbPr(const struct Pnm_rgb *pixels,
+                             struct YPbPr_pixel *out, int count,
+                             unsigned denominator);
+static void scalarRowToRGB(const struct YPbPr_pixel *pixels,
+                           struct Pnm_rgb *out, int count,
+                           unsigned denominator);
+static void scalarRowToBytes(const struct YPbPr_pixel *pixels,
+                             unsigned char *out, int count);
+
+/*
+ * Name:       rgbRowToYPbPr
+ * Purpose:    Converts a row of pixels from RGB color space to component
+ *             video color space
+ * Parameters: const struct Pnm_rgb *pixels: the pixels to convert
+ *             struct YPbPr_pixel *out: where the converted pixels are
+ *             stored
+ *             int count: the number of pixels
+ *             unsigned denominator: an integer representing the maximum
+ *             color value
+ * Return:     None
+ * Expects:    pixels and out to hold count pixels each and not to overlap
+ *             the color values to be at most denominator
+ * Notes:      safe to call from several threads at once
+ *             out[i] is exactly what pixelToYPbPr(&pixels[i], denominator)
+ *             returns
+ */
+void rgbRowToYPbPr(const struct Pnm_rgb *pixels, struct YPbPr_pixel *out,
+                   int count, unsigned denominator)
+{
+        pthread_once(&setupOnce, setup);
+        toYPbPr(pixels, out, count, denominator);
+}
+
+/*
+ * Name:       YPbPrRowToRGB
+ * Purpose:    Converts a row of pixels from component video color space to
+ *             RGB color space
+ * Parameters: const struct YPbPr_pixel *pixels: the pixels to convert
+ *             struct Pnm_rgb *out: where the converted pixels are stored
+ *             int count: the number of pixels
+ *             unsigned denominator: an integer representing the maximum
+ *             color value
+ * Return:     None
+ * Expects:    pixels and out to hold count pixels each and not to overlap
+ *             denominator to be at most 65535
+ * Notes:      safe to call from several threads at once
+ *             out[i] is exactly what pixelToRGB(&pixels[i], denominator)
+ *             returns
+ */
+void YPbPrRowToRGB(const struct YPbPr_pixel *pixels, struct Pnm_rgb *out,
+                   int count, unsigned denominator)
+{
+        pthread_once(&setupOnce, setup);
+        toRGB(pixels, out, count, denominator);
+}
+
+/*
+ * Name:       YPbPrRowToBytes
+ * Purpose:    Converts a row of pixels from component video color space to
+ *             the bytes a raw PPM with a maximum color value of 255 stores
+ *             for them
+ * Parameters: const struct YPbPr_pixel *pixels: the pixels to convert
+ *             unsigned char *out: where the 3 * count bytes are stored
+ *             int count: the number of pixels
+ * Return:     None
+ * Expects:    pixels and out to hold count pixels each and not to overlap
+ * Notes:      safe to call from several threads at once
+ *             the bytes of out[3 * i] on are the red, green, and blue of
+ *             pixelToRGB(&pixels[i], 255)
+ */
+void YPbPrRowToBytes(const struct YPbPr_pixel *pixels, unsigned char *out,
+                     int count)
+{
+        pthread_once(&setupOnce, setup);
+        toBytes(pixels, out, count);
+}
+
+/*
+ * Name:       scalarRowToYPbPr
+ * Purpose:    a private function that converts a row of pixels to
+ *             component video color space one pixel at a time, with the
+ *             tables for denominator
+ * Parameters: const struct Pnm_rgb *pixels: the pixels to convert
+ *             struct YPbPr_pixel *out: where the converted pixels are
+ *             stored
+ *             int count: the number of pixels
+ *             unsigned denominator: the maximum color value
+ * Return:     None
+ * Expects:    pixels and out to hold count pixels each
+ * Notes:      None
+ */
+static void scalarRowToYPbPr(const struct Pnm_rgb *pixels,
+                             struct YPbPr_pixel *out, int count,
+                             unsigned denominator)
+{
+        tableRowToYPbPr(colorTable(denominator), pixels, out, count);
+}
+
+/*
+ * Name:       scalarRowToRGB
+ * Purpose:    a private function that converts a row of pixels to RGB
+ *             color space one pixel at a time
+ * Parameters: const struct YPbPr_pixel *pixels: the pixels to convert
+ *             struct Pnm_rgb *out: where the converted pixels are stored
+ *             int count: the number of pixels
+ *             unsigned denominator: the maximum color value
+ * Return:     None
+ * Expects:    pixels and out to hold count pixels each
+ * Notes:      None
+ */
+static void scalarRowToRGB(const struct YPbPr_pixel *pixels,
+                           struct Pnm_rgb *out, int count,
+                           unsigned denominator)
+{
+        for (int i = 0; i < count; i++) {
+                struct YPbPr_pixel pixel = pixels[i];
+                out[i] = pixelToRGB(&pixel, denominator);
+        }
+}
+
+/*
+ * Name:       scalarRowToBytes
+ * Purpose:    a private function that converts a row of pixels to the
+ *             bytes of a raw PPM one pixel at a time
+ * Parameters: const struct YPbPr_pixel *pixels: the pixels to convert
+ *             unsigned char *out: where the 3 * count bytes are stored
+ *             int count: the number of pixels
+ * Return:     None
+ * Expects:    pixels and out to hold count pixels each
+ * Notes:      None
+ */
+static void scalarRowToBytes(const struct YPbPr_pixel *pixels,
+                             unsigned char *out, int count)
+{
+        for (int i = 0; i < count; i++) {
+                struct YPbPr_pixel pixel = pixels[i];
+                struct Pnm_rgb rgb = pixelToRGB(&pixel, 255);
+                out[3 * i] = rgb.red;
+                out[3 * i + 1] = rgb.green;
+                out[3 * i + 2] = rgb.blue;
+        }
+}
+
+#ifdef HAVE_VECTOR_KERNELS
+/*
+ * Name:       splitThree
+ * Purpose:    a private function that splits 4 structs of three 4-byte
+ *             fields into one vector per field
+ * Parameters: __m128 v0, v1, v2: the 12 fields in memory order, which is
+ *             a0 b0 c0 a1 | b1 c1 a2 b2 | c2 a3 b3 c3
+ *             __m128 *a, *b, *c: where each field is stored, one struct
+ *             per lane
+ * Return:     None
+ * Expects:    the processor to support SSE4.1
+ * Notes:      each blend gathers one field in a rotated order, which the
+ *             shuffle then puts right
+ */
+__attribute__((target("sse4.1"))) static inline void
+splitThree(__m128 v0, __m128 v1, __m128 v2, __m128 *a, __m128 *b,
+           __m128 *c)
+{
+        __m128 first = _mm_blend_ps(_mm_blend_ps(v0, v1, 0x4), v2, 0x2);
+        __m128 second = _mm_blend_ps(_mm_blend_ps(v0, v1, 0x9), v2, 0x4);
+        __m128 third = _mm_blend_ps(_mm_blend_ps(v0, v1, 0x2), v2, 0x9);
+
+        *a = _mm_shuffle_ps(first, first, _MM_SHUFFLE(1, 2, 3, 0));
+        *b = _mm_shuffle_ps(second, second, _MM_SHUFFLE(2, 3, 0, 1));
+        *c = _mm_shuffle_ps(third, third, _MM_SHUFFLE(3, 0, 1, 2));
+}
+
+/*
+ * Name:       joinThree
+ * Purpose:    a private function that puts one vector per field back
+ *             together into 4 structs of three 4-byte fields
+ * Parameters: __m128 a, b, c: the fields, one struct per lane
+ *             __m128 *v0, *v1, *v2: where the 12 fields are stored in
+ *             memory order
+ * Return:     None
+ * Expects:    the processor to support SSE4.1
+ * Notes:      splitThree() in reverse
+ */
+__attribute__((target("sse4.1"))) static inline void
+joinThree(__m128 a, __m128 b, __m128 c, __m128 *v0, __m128 *v1,
+          __m128 *v2)
+{
+        a = _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 2, 3, 0));
+        b = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1));
+        c = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 1, 2));
+
+        *v0 = _mm_blend_ps(_mm_blend_ps(a, b, 0x2), c, 0x4);
+        *v1 = _mm_blend_ps(_mm_blend_ps(b, c, 0x2), a, 0x4);
+        *v2 = _mm_blend_ps(_mm_blend_ps(c, a, 0x2), b, 0x4);
+}
+
+/*
+ * Name:       loadRGB
+ * Purpose:    a private function that loads 4 pixels and splits them into
+ *             their red, green, and blue values as floats divided by the
+ *             maximum color value
+ * Parameters: const struct Pnm_rgb *pixels: the 4 pixels
+ *             __m128 denominator: the maximum color value in every lane
+ *             __m128 *r, *g, *b: where the values are stored, one pixel
+ *             per lane
+ * Return:     None
+ * Expects:    the processor to support SSE4.1
+ * Notes:      None
+ */
+__attribute__((target("sse4.1"))) static inline void
+loadRGB(const struct Pnm_rgb *pixels, __m128 denominator, __m128 *r,
+        __m128 *g, __m128 *b)
+{
+        const __m128i *values = (const __m128i *) pixels;
+        __m128 v0 = _mm_cvtepi32_ps(_mm_loadu_si128(values));
+        __m128 v1 = _mm_cvtepi32_ps(_mm_loadu_si128(values + 1));
+        __m128 v2 = _mm_cvtepi32_ps(_mm_loadu_si128(values + 2));
+
+        __m128 red, green, blue;
+        splitThree(v0, v1, v2, &red, &green, &blue);
+
+        *r = _mm_div_ps(red, denominator);
+        *g = _mm_div_ps(green, denominator);
+        *b = _mm_div_ps(blue, denominator);
+}
+
+/*
+ * Name:       storeYPbPr
+ * Purpose:    a private function that clamps 4 converted pixels and
+ *             stores them as YPbPr_pixel structs
+ * Parameters: struct YPbPr_pixel *out: where the 4 pixels are stored
+ *             __m128 Y, Pb, Pr: the unclamped values, one pixel per lane
+ * Return:     None
+ * Expects:    the processor to support SSE4.1
+ * Notes:      the min and max operands are ordered so a value equal to a
+ *             limit is kept as is, just like clamp() in convertColor.c
+ */
+__attribute__((target("sse4.1"))) static inline void
+storeYPbPr(struct YPbPr_pixel *out, __m128 Y, __m128 Pb, __m128 Pr)
+{
+        __m128 half = _mm_set1_ps(0.5f);
+        __m128 negativeHalf = _mm_set1_ps(-0.5f);
+        Y = _mm_min_ps(_mm_set1_ps(1.0f), _mm_max_ps(_mm_setzero_ps(), Y));
+        Pb = _mm_min_ps(half, _mm_max_ps(negativeHalf, Pb));
+        Pr = _mm_min_ps(half, _mm_max_ps(negativeHalf, Pr));
+
+        __m128 v0, v1, v2;
+        joinThree(Y, Pb, Pr, &v0, &v1, &v2);
+
+        float *values = (float *) out;
+        _mm_storeu_ps(values, v0);
+        _mm_storeu_ps(values + 4, v1);
+        _mm_storeu_ps(values + 8, v2);
+}
+
+/*
+ * Name:       sseConvert
+ * Purpose:    a private function that converts 4 pixels to component
+ *             video color space with SSE4.1
+ * Parameters: const struct Pnm_rgb *pixels: the 4 pixels to convert
+ *             struct YPbPr_pixel *out: where the converted pixels are
+ *             stored
+ *             __m128 denominator: the maximum color value in every lane
+ * Return:     None
+ * Expects:    the processor to support SSE4.1
+ * Notes:      the sums are done two pixels at a time in double
+ */
+__attribute__((target("sse4.1"))) static inline void
+sseConvert(const struct Pnm_rgb *pixels, struct YPbPr_pixel *out,
+           __m128 denominator)
+{
+        __m128 r, g, b;
+        loadRGB(pixels, denominator, &r, &g, &b);
+
+        __m128d rd[2] = { _mm_cvtps_pd(r), _mm_cvtps_pd(_mm_movehl_ps(r, r)) };
+        __m128d gd[2] = { _mm_cvtps_pd(g), _mm_cvtps_pd(_mm_movehl_ps(g, g)) };
+        __m128d bd[2] = { _mm_cvtps_pd(b), _mm_cvtps_pd(_mm_movehl_ps(b, b)) };
+
+        __m128 Y[2], Pb[2], Pr[2];
+        for (int i = 0; i < 2; i++) {
+                __m128d sum = _mm_add_pd(
+                        _mm_add_pd(_mm_mul_pd(_mm_set1_pd(0.299), rd[i]),
+                                   _mm_mul_pd(_mm_set1_pd(0.587), gd[i])),
+                        _mm_mul_pd(_mm_set1_pd(0.114), bd[i]));
+                Y[i] = _mm_cvtpd_ps(sum);
+
+                sum = _mm_add_pd(
+                        _mm_sub_pd(_mm_mul_pd(_mm_set1_pd(-0.168736), rd[i]),
+                                   _mm_mul_pd(_mm_set1_pd(0.331264), gd[i])),
+                        _mm_mul_pd(_mm_set1_pd(0.5), bd[i]));
+                Pb[i] = _mm_cvtpd_ps(sum);
+
+                sum = _mm_sub_pd(
+                        _mm_sub_pd(_mm_mul_pd(_mm_set1_pd(0.5), rd[i]),
+                                   _mm_mul_pd(_mm_set1_pd(0.418688), gd[i])),
+                        _mm_mul_pd(_mm_set1_pd(0.081312), bd[i]));
+                Pr[i] = _mm_cvtpd_ps(sum);
+        }
+
+        storeYPbPr(out, _mm_movelh_ps(Y[0], Y[1]),
+                   _mm_movelh_ps(Pb[0], Pb[1]), _mm_movelh_ps(Pr[0], Pr[1]));
+}
+
+/*
+ * Name:       sseRowToYPbPr
+ * Purpose:    a private function that converts a row of pixels to
+ *             component video color space with SSE4.1
+ * Parameters: const struct Pnm_rgb *pixels: the pixels to convert
+ *             struct YPbPr_pixel *out: where the converted pixels are
+ *             stored
+ *             int count: the number of pixels
+ *             unsigned denominator: the maximum color value
+ * Return:     None
+ * Expects:    the processor to support SSE4.1
+ * Notes:      converts 8 pixels per step, then finishes the row with
+ *             scalarRowToYPbPr()
+ */
+__attribute__((target("sse4.1"))) static void
+sseRowToYPbPr(const struct Pnm_rgb *pixels, struct YPbPr_pixel *out,
+              int count, unsigned denominator)
+{
+        __m128 denominators = _mm_set1_ps((float) denominator);
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+                sseConvert(pixels + i, out + i, denominators);
+                sseConvert(pixels + i + 4, out + i + 4, denominators);
+        }
+        scalarRowToYPbPr(pixels + i, out + i, count - i, denominator);
+}
+
+/*
+ * Name:       avxConvert
+ * Purpose:    a private function that converts 4 pixels to component
+ *             video color space with AVX2
+ * Parameters: const struct Pnm_rgb *pixels: the 4 pixels to convert
+ *             struct YPbPr_pixel *out: where the converted pixels are
+ *             stored
+ *             __m128 denominator: the maximum color value in every lane
+ * Return:     None
+ * Expects:    the processor to support AVX2
+ * Notes:      the sums are done four pixels at a time in double
+ */
+__attribute__((target("avx2"))) static inline void
+avxConvert(const struct Pnm_rgb *pixels, struct YPbPr_pixel *out,
+           __m128 denominator)
+{
+        __m128 r, g, b;
+        loadRGB(pixels, denominator, &r, &g, &b);
+        __m256d rd = _mm256_cvtps_pd(r);
+        __m256d gd = _mm256_cvtps_pd(g);
+        __m256d bd = _mm256_cvtps_pd(b);
+
+        __m256d Y = _mm256_add_pd(
+                _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(0.299), rd),
+                              _mm256_mul_pd(_mm256_set1_pd(0.587), gd)),
+                _mm256_mul_pd(_mm256_set1_pd(0.114), bd));
+        __m256d Pb = _mm256_add_pd(
+                _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(-0.168736), rd),
+                              _mm256_mul_pd(_mm256_set1_pd(0.331264), gd)),
+                _mm256_mul_pd(_mm256_set1_pd(0.5), bd));
+        __m256d Pr = _mm256_sub_pd(
+                _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(0.5), rd),
+                              _mm256_mul_pd(_mm256_set1_pd(0.418688), gd)),
+                _mm256_mul_pd(_mm256_set1_pd(0.081312), bd));
+
+        storeYPbPr(out, _mm256_cvtpd_ps(Y), _mm256_cvtpd_ps(Pb),
+                   _mm256_cvtpd_ps(Pr));
+}
+
+/*
+ * Name:       avxRowToYPbPr
+ * Purpose:    a private function that converts a row of pixels to
+ *             component video color space with AVX2
+ * Parameters: const struct Pnm_rgb *pixels: the pixels to convert
+ *             struct YPbPr_pixel *out: where the converted pixels are
+ *             stored
+ *             int count: the number of pixels
+ *             unsigned denominator: the maximum color value
+ * Return:     None
+ * Expects:    the processor to support AVX2
+ * Notes:      converts 8 pixels per step, then finishes the row with
+ *             scalarRowToYPbPr(). The target leaves out FMA on purpose:
+ *             a fused multiply-add rounds differently than pixelToYPbPr().
+ */
+__attribute__((target("avx2"))) static void
+avxRowToYPbPr(const struct Pnm_rgb *pixels, struct YPbPr_pixel *out,
+              int count, unsigned denominator)
+{
+        __m128 denominators = _mm_set1_ps((float) denominator);
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+                avxConvert(pixels + i, out + i, denominators);
+                avxConvert(pixels + i + 4, out + i + 4, denominators);
+        }
+        scalarRowToYPbPr(pixels + i, out + i, count - i, denominator);
+}
+
+/*
+ * Name:       loadYPbPr
+ * Purpose:    a private function that loads 4 pixels in component video
+ *             color space and splits them into their Y, Pb, and Pr values
+ * Parameters: const struct YPbPr_pixel *pixels: the 4 pixels
+ *             __m128 *Y, *Pb, *Pr: where the values are stored, one pixel
+ *             per lane
+ * Return:     None
+ * Expects:    the processor to support SSE4.1
+ * Notes:      None
+ */
+__attribute__((target("sse4.1"))) static inline void
+loadYPbPr(const struct YPbPr_pixel *pixels, __m128 *Y, __m128 *Pb,
+          __m128 *Pr)
+{
+        const float *values = (const float *) pixels;
+        splitThree(_mm_loadu_ps(values), _mm_loadu_ps(values + 4),
+                   _mm_loadu_ps(values + 8), Y, Pb, Pr);
+}
+
+/*
+ * Name:       scaleColor
+ * Purpose:    a private function that clamps 4 red, green, or blue values
+ *             and scales them to integers from 0 to the maximum color value
+ * Parameters: __m128 value: the unclamped values, one pixel per lane
+ *             __m128 denominator: the maximum color value in every lane
+ * Return:     the scaled values as 32-bit integers
+ * Expects:    the processor to support SSE4.1
+ * Notes:      round() rounds halves away from zero, which for values that
+ *             are never negative is the floor plus 1 when the part the
+ *             floor drops is at least 0.5; that part is found exactly by
+ *             subtracting the floor
+ */
+__attribute__((target("sse4.1"))) static inline __m128i
+scaleColor(__m128 value, __m128 denominator)
+{
+        __m128 one = _mm_set1_ps(1.0f);
+        value = _mm_min_ps(one, _mm_max_ps(_mm_setzero_ps(), value));
+        value = _mm_mul_ps(value, denominator);
+
+        __m128 whole = _mm_floor_ps(value);
+        __m128 roundUp = _mm_cmpge_ps(_mm_sub_ps(value, whole),
+                                      _mm_set1_ps(0.5f));
+        whole = _mm_add_ps(whole, _mm_and_ps(roundUp, one));
+        return _mm_cvttps_epi32(whole);
+}
+
+/*
+ * Name:       joinRGB
+ * Purpose:    a private function that scales 4 pixels' red, green, and
+ *             blue values and puts them back together as Pnm_rgb structs
+ * Parameters: __m128 r, g, b: the unclamped values, one pixel per lane
+ *             __m128 denominator: the maximum color value in every lane
+ *             __m128i rgb[3]: where the 12 values are stored in the order
+ *             4 Pnm_rgb structs store them
+ * Return:     None
+ * Expects:    the processor to support SSE4.1
+ * Notes:      None
+ */
+__attribute__((target("sse4.1"))) static inline void
+joinRGB(__m128 r, __m128 g, __m128 b, __m128 denominator, __m128i rgb[3])
+{
+        __m128 v0, v1, v2;
+        joinThree(_mm_castsi128_ps(scaleColor(r, denominator)),
+                  _mm_castsi128_ps(scaleColor(g, denominator)),
+                  _mm_castsi128_ps(scaleColor(b, denominator)), &v0, &v1,
+                  &v2);
+        rgb[0] = _mm_castps_si128(v0);
+        rgb[1] = _mm_castps_si128(v1);
+        rgb[2] = _mm_castps_si128(v2);
+}
+
+/*
+ * Name:       packBytes
+ * Purpose:    a private function that stores the values of 8 pixels as the
+ *             24 bytes of a raw PPM
+ * Parameters: const __m128i rgb[6]: the 24 values, in the order Pnm_rgb
+ *             structs store them
+ *             unsigned char *out: where the bytes are stored
+ * Return:     None
+ * Expects:    the processor to support SSE4.1
+ *             every value to be at most 255
+ * Notes:      None
+ */
+__attribute__((target("sse4.1"))) static inline void
+packBytes(const __m128i rgb[6], unsigned char *out)
+{
+        __m128i low = _mm_packus_epi32(rgb[0], rgb[1]);
+        __m128i middle = _mm_packus_epi32(rgb[2], rgb[3]);
+        __m128i high = _mm_packus_epi32(rgb[4], rgb[5]);
+
+        _mm_storeu_si128((__m128i *) out, _mm_packus_epi16(low, middle));
+        _mm_storel_epi64((__m128i *) (out + 16),
+                         _mm_packus_epi16(high, high));
+}
+
+/*
+ * Name:       sseToRGB
+ * Purpose:    a private function that converts 4 pixels to RGB color space
+ *             with SSE4.1
+ * Parameters: const struct YPbPr_pixel *pixels: the 4 pixels to convert
+ *             __m128 denominator: the maximum color value in every lane
+ *             __m128i rgb[3]: where the 12 values are stored in the order
+ *             4 Pnm_rgb structs store them
+ * Return:     None
+ * Expects:    the processor to support SSE4.1
+ * Notes:      the sums are done two pixels at a time in double. The
+ *             0 * Pb and 0.0 * Pr terms of pixelToRGB() are left out: they
+ *             can only change the sign of a zero, which clamping and
+ *             rounding do not see.
+ */
+__attribute__((target("sse4.1"))) static inline void
+sseToRGB(const struct YPbPr_pixel *pixels, __m128 denominator,
+         __m128i rgb[3])
+{
+        __m128 Y, Pb, Pr;
+        loadYPbPr(pixels, &Y, &Pb, &Pr);
+
+        __m128d Yd[2] = { _mm_cvtps_pd(Y), _mm_cvtps_pd(_mm_movehl_ps(Y, Y)) };
+        __m128d Pbd[2] = { _mm_cvtps_pd(Pb),
+                           _mm_cvtps_pd(_mm_movehl_ps(Pb, Pb)) };
+        __m128d Prd[2] = { _mm_cvtps_pd(Pr),
+                           _mm_cvtps_pd(_mm_movehl_ps(Pr, Pr)) };
+
+        __m128 r[2], g[2], b[2];
+        for (int i = 0; i < 2; i++) {
+                r[i] = _mm_cvtpd_ps(_mm_add_pd(
+                        Yd[i], _mm_mul_pd(_mm_set1_pd(1.402), Prd[i])));
+                g[i] = _mm_cvtpd_ps(_mm_sub_pd(
+                        _mm_sub_pd(Yd[i],
+                                   _mm_mul_pd(_mm_set1_pd(0.344136), Pbd[i])),
+                        _mm_mul_pd(_mm_set1_pd(0.714136), Prd[i])));
+                b[i] = _mm_cvtpd_ps(_mm_add_pd(
+                        Yd[i], _mm_mul_pd(_mm_set1_pd(1.772), Pbd[i])));
+        }
+
+        joinRGB(_mm_movelh_ps(r[0], r[1]), _mm_movelh_ps(g[0], g[1]),
+                _mm_movelh_ps(b[0], b[1]), denominator, rgb);
+}
+
+/*
+ * Name:       sseRowToRGB
+ * Purpose:    a private function that converts a row of pixels to RGB
+ *             color space with SSE4.1
+ * Parameters: const struct YPbPr_pixel *pixels: the pixels to convert
+ *             struct Pnm_rgb *out: where the converted pixels are stored
+ *             int count: the number of pixels
+ *             unsigned denominator: the maximum color value
+ * Return:     None
+ * Expects:    the processor to support SSE4.1
+ * Notes:      converts 8 pixels per step, then finishes the row with
+ *             scalarRowToRGB()
+ */
+__attribute__((target("sse4.1"))) static void
+sseRowToRGB(const struct YPbPr_pixel *pixels, struct Pnm_rgb *out,
+            int count, unsigned denominator)
+{
+        __m128 denominators = _mm_set1_ps((float) denominator);
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+                __m128i rgb[6];
+                sseToRGB(pixels + i, denominators, rgb);
+                sseToRGB(pixels + i + 4, denominators, rgb + 3);
+
+                __m128i *values = (__m128i *) (out + i);
+                for (int j = 0; j < 6; j++) {
+                        _mm_storeu_si128(values + j, rgb[j]);
+                }
+        }
+        scalarRowToRGB(pixels + i, out + i, count - i, denominator);
+}
+
+/*
+ * Name:       sseRowToBytes
+ * Purpose:    a private function that converts a row of pixels to the
+ *             bytes of a raw PPM with SSE4.1
+ * Parameters: const struct YPbPr_pixel *pixels: the pixels to convert
+ *             unsigned char *out: where the 3 * count bytes are stored
+ *             int count: the number of pixels
+ * Return:     None
+ * Expects:    the processor to support SSE4.1
+ * Notes:      converts 8 pixels per step, then finishes the row with
+ *             scalarRowToBytes()
+ */
+__attribute__((target("sse4.1"))) static void
+sseRowToBytes(const struct YPbPr_pixel *pixels, unsigned char *out,
+              int count)
+{
+        __m128 denominators = _mm_set1_ps(255.0f);
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+                __m128i rgb[6];
+                sseToRGB(pixels + i, denominators, rgb);
+                sseToRGB(pixels + i + 4, denominators, rgb + 3);
+                packBytes(rgb, out + 3 * i);
+        }
+        scalarRowToBytes(pixels + i, out + 3 * i, count - i);
+}
+
+/*
+ * Name:       avxToRGB
+ * Purpose:    a private function that converts 4 pixels to RGB color space
+ *             with AVX2
+ * Parameters: const struct YPbPr_pixel *pixels: the 4 pixels to convert
+ *             __m128 denominator: the maximum color value in every lane
+ *             __m128i rgb[3]: where the 12 values are stored in the order
+ *             4 Pnm_rgb structs store them
+ * Return:     None
+ * Expects:    the processor to support AVX2
+ * Notes:      the sums are done four pixels at a time in double, leaving
+ *             out the same terms as sseToRGB()
+ */
+__attribute__((target("avx2"))) static inline void
+avxToRGB(const struct YPbPr_pixel *pixels, __m128 denominator,
+         __m128i rgb[3])
+{
+        __m128 Y, Pb, Pr;
+        loadYPbPr(pixels, &Y, &Pb, &Pr);
+        __m256d Yd = _mm256_cvtps_pd(Y);
+        __m256d Pbd = _mm256_cvtps_pd(Pb);
+        __m256d Prd = _mm256_cvtps_pd(Pr);
+
+        __m256d r = _mm256_add_pd(Yd, _mm256_mul_pd(_mm256_set1_pd(1.402),
+                                                    Prd));
+        __m256d g = _mm256_sub_pd(
+                _mm256_sub_pd(Yd, _mm256_mul_pd(_mm256_set1_pd(0.344136),
+                                                Pbd)),
+                _mm256_mul_pd(_mm256_set1_pd(0.714136), Prd));
+        __m256d b = _mm256_add_pd(Yd, _mm256_mul_pd(_mm256_set1_pd(1.772),
+                                                    Pbd));
+
+        joinRGB(_mm256_cvtpd_ps(r), _mm256_cvtpd_ps(g), _mm256_cvtpd_ps(b),
+                denominator, rgb);
+}
+
+/*
+ * Name:       avxRowToRGB
+ * Purpose:    a private function that converts a row of pixels to RGB
+ *             color space with AVX2
+ * Parameters: const struct YPbPr_pixel *pixels: the pixels to convert
+ *             struct Pnm_rgb *out: where the converted pixels are stored
+ *             int count: the number of pixels
+ *             unsigned denominator: the maximum color value
+ * Return:     None
+ * Expects:    the processor to support AVX2
+ * Notes:      converts 8 pixels per step, then finishes the row with
+ *             scalarRowToRGB()
+ */
+__attribute__((target("avx2"))) static void
+avxRowToRGB(const struct YPbPr_pixel *pixels, struct Pnm_rgb *out,
+            int count, unsigned denominator)
+{
+        __m128 denominators = _mm_set1_ps((float) denominator);
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+                __m128i rgb[6];
+                avxToRGB(pixels + i, denominators, rgb);
+                avxToRGB(pixels + i + 4, denominators, rgb + 3);
+
+                __m128i *values = (__m128i *) (out + i);
+                for (int j = 0; j < 6; j++) {
+                        _mm_storeu_si128(values + j, rgb[j]);
+                }
+        }
+        scalarRowToRGB(pixels + i, out + i, count - i, denominator);
+}
+
+/*
+ * Name:       avxRowToBytes
+ * Purpose:    a private function that converts a row of pixels to the
+ *             bytes of a raw PPM with AVX2
+ * Parameters: const struct YPbPr_pixel *pixels: the pixels to convert
+ *             unsigned char *out: where the 3 * count bytes are stored
+ *             int count: the number of pixels
+ * Return:     None
+ * Expects:    the processor to support AVX2
+ * Notes:      converts 8 pixels per step, then finishes the row with
+ *             scalarRowToBytes()
+ */
+__attribute__((target("avx2"))) static void
+avxRowToBytes(const struct YPbPr_pixel *pixels, unsigned char *out,
+              int count)
+{
+        __m128 denominators = _mm_set1_ps(255.0f);
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+                __m128i rgb[6];
+                avxToRGB(pixels + i, denominators, rgb);
+                avxToRGB(pixels + i + 4, denominators, rgb + 3);
+                packBytes(rgb, out + 3 * i);
+        }
+        scalarRowToBytes(pixels + i, out + 3 * i, count - i);
+}
+#endif
+
+/*
+ * Name:       setup
+ * Purpose:    a private function that picks the fastest row conversions
+ *             this processor supports
+ * Parameters: None
+ * Return:     None
+ * Expects:    to be run once, through pthread_once()
+ * Notes:      None
+ */
+static void setup(void)
+{
+        toYPbPr = scalarRowToYPbPr;
+        toRGB = scalarRowToRGB;
+        toBytes = scalarRowToBytes;
+#ifdef HAVE_VECTOR_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+                toYPbPr = avxRowToYPbPr;
+                toRGB = avxRowToRGB;
+                toBytes = avxRowToBytes;
+        } else if (__builtin_cpu_supports("sse4.1")) {
+                toYPbPr = sseRowToYPbPr;
+                toRGB = sseRowToRGB;
+                toBytes = sseRowToBytes;
+        }
+#endif
+}
@@ -0,0 +1,32 @@
+/**************************************************************
+ *                     colorKernel.h
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the function declarations for colorKernel.c,
+ *     which converts whole rows of pixels between RGB and component video
+ *     color space. Each row function gives exactly the same results as
+ *     calling the matching per-pixel function in convertColor.c on every
+ *     pixel of the row (a tolerance of 0), so the rows can be used
+ *     anywhere those are without changing a single output byte.
+ *
+ **************************************************************/
+#ifndef COLOR_KERNEL_H
+#define COLOR_KERNEL_H
+
+#include "pnm.h"
+#include "helpers.h"
+
+void rgbRowToYPbPr(const struct Pnm_rgb *pixels, struct YPbPr_pixel *out,
+                   int count, unsigned denominator);
+void YPbPrRowToRGB(const struct YPbPr_pixel *pixels, struct Pnm_rgb *out,
+                   int count, unsigned denominator);
+void YPbPrRowToBytes(const struct YPbPr_pixel *pixels, unsigned char *out,
+                     int count);
+
+#endif
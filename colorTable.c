@@ -0,0 +1,315 @@
+/**************************************************************
+ *                     colorTable.c
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the implementations for colorTable(),
+ *     tableToYPbPr(), and tableRowToYPbPr(). A color value can only be
+ *     0 through the maximum color value, so everything pixelToYPbPr()
+ *     computes from one value alone is worked out once, into a table, and
+ *     a pixel is converted with lookups and adds.
+ *
+ *     The tables come in two tiers. Up to a maximum color value of 255
+ *     each color value has its own Y, Pb, and Pr contributions, the double
+ *     products pixelToYPbPr() multiplies out, so a pixel takes 9 lookups
+ *     and 6 adds. Above that (16-bit images) a full set of contributions
+ *     would take 4.5 megabytes, so the table only holds each color value
+ *     divided by the maximum, which saves the divides but not the
+ *     multiplies. Either way the products and sums are the same double
+ *     operations, done in the same order, so the results are bit-for-bit
+ *     those of pixelToYPbPr().
+ *
+ **************************************************************/
+#include "colorTable.h"
+#include "assert.h"
+#include <stdlib.h>
+#include <pthread.h>
+
+/* The largest maximum color value given a full table of contributions */
+static const unsigned CONTRIBUTION_LIMIT = 255;
+
+/*
+ * Name:       Contribution
+ * Purpose:    Holds what one color value adds to each component of a pixel
+ *             in component video color space
+ * Components:
+ *             double Y, Pb, Pr: the signed products pixelToYPbPr() adds
+ *             for this color value
+ */
+struct Contribution {
+        double Y;
+        double Pb;
+        double Pr;
+};
+
+/*
+ * Name:       Color_table
+ * Purpose:    Holds the tables for one maximum color value
+ * Components:
+ *             unsigned denominator: the maximum color value the tables are
+ *             for
+ *             struct Contribution *red, *green, *blue: the contributions
+ *             of each color value of each channel, or NULL above
+ *             CONTRIBUTION_LIMIT
+ *             float *quotient: each color value divided by denominator,
+ *             or NULL up to CONTRIBUTION_LIMIT
+ *             struct Color_table *next: the table built before this one
+ */
+struct Color_table {
+        unsigned denominator;
+        struct Contribution *red;
+        struct Contribution *green;
+        struct Contribution *blue;
+        float *quotient;
+        struct Color_table *next;
+};
+
+static struct Color_table *latest;
+static pthread_mutex_t tablesLock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct Color_table *newTable(unsigned denominator);
+static struct YPbPr_pixel lookUp(const struct Color_table *table,
+                                 const struct Pnm_rgb *pixel);
+static struct YPbPr_pixel addContributions(const struct Color_table *table,
+                                           const struct Pnm_rgb *pixel);
+static struct YPbPr_pixel multiplyQuotients(const struct Color_table *table,
+                                            const struct Pnm_rgb *pixel);
+static float clamp(float value, float min, float max);
+
+/*
+ * Name:       colorTable
+ * Purpose:    Finds the tables for a maximum color value, building them
+ *             the first time they are asked for
+ * Parameters: unsigned denominator: the maximum color value
+ * Return:     the tables for denominator
+ * Expects:    denominator to be between 1 and 65535
+ * Notes:      will CRE if denominator is out of range or if memory cannot
+ *             be allocated
+ *             safe to call from several threads at once; the tables are
+ *             built once, and kept until the program ends, so asking again
+ *             for the same image only costs a comparison
+ */
+const struct Color_table *colorTable(unsigned denominator)
+{
+        assert(denominator >= 1 && denominator <= 65535);
+        struct Color_table *table = __atomic_load_n(&latest,
+                                                    __ATOMIC_ACQUIRE);
+        if (table != NULL && table->denominator == denominator) {
+                return table;
+        }
+
+        pthread_mutex_lock(&tablesLock);
+        for (table = latest; table != NULL; table = table->next) {
+                if (table->denominator == denominator) {
+                        break;
+                }
+        }
+        if (table == NULL) {
+                table = newTable(denominator);
+                table->next = latest;
+                __atomic_store_n(&latest, table, __ATOMIC_RELEASE);
+        }
+        pthread_mutex_unlock(&tablesLock);
+
+        return table;
+}
+
+/*
+ * Name:       tableToYPbPr
+ * Purpose:    Converts a single pixel in RGB color space to component
+ *             video color space
+ * Parameters: const struct Color_table *table: the tables for the pixel's
+ *             maximum color value
+ *             const struct Pnm_rgb *pixel: the pixel to convert
+ * Return:     exactly what pixelToYPbPr() returns for pixel
+ * Expects:    table and pixel to not be NULL
+ *             the color values to be at most the table's denominator
+ * Notes:      will CRE if table or pixel is NULL
+ */
+struct YPbPr_pixel tableToYPbPr(const struct Color_table *table,
+                                const struct Pnm_rgb *pixel)
+{
+        assert(table != NULL && pixel != NULL);
+        return lookUp(table, pixel);
+}
+
+/*
+ * Name:       tableRowToYPbPr
+ * Purpose:    Converts a row of pixels in RGB color space to component
+ *             video color space
+ * Parameters: const struct Color_table *table: the tables for the pixels'
+ *             maximum color value
+ *             const struct Pnm_rgb *pixels: the pixels to convert
+ *             struct YPbPr_pixel *out: where the converted pixels are
+ *             stored
+ *             int count: the number of pixels
+ * Return:     None
+ * Expects:    table to not be NULL
+ *             pixels and out to hold count pixels each
+ *             the color values to be at most the table's denominator
+ * Notes:      will CRE if table is NULL
+ */
+void tableRowToYPbPr(const struct Color_table *table,
+                     const struct Pnm_rgb *pixels, struct YPbPr_pixel *out,
+                     int count)
+{
+        assert(table != NULL);
+        if (table->quotient == NULL) {
+                for (int i = 0; i < count; i++) {
+                        out[i] = addContributions(table, &pixels[i]);
+                }
+                return;
+        }
+        for (int i = 0; i < count; i++) {
+                out[i] = multiplyQuotients(table, &pixels[i]);
+        }
+}
+
+/*
+ * Name:       newTable
+ * Purpose:    a private function that builds the tables for a maximum
+ *             color value
+ * Parameters: unsigned denominator: the maximum color value
+ * Return:     the new tables
+ * Expects:    denominator to be between 1 and 65535
+ * Notes:      will CRE if memory cannot be allocated
+ *             each entry is computed with the same float divide and double
+ *             multiply pixelToYPbPr() uses; the Pb and Pr products it
+ *             subtracts are stored negated, since adding a negated double
+ *             is exactly the same as subtracting it
+ */
+static struct Color_table *newTable(unsigned denominator)
+{
+        struct Color_table *table = malloc(sizeof(*table));
+        assert(table != NULL);
+        table->denominator = denominator;
+        table->red = table->green = table->blue = NULL;
+        table->quotient = NULL;
+
+        size_t values = (size_t) denominator + 1;
+        if (denominator > CONTRIBUTION_LIMIT) {
+                table->quotient = malloc(values * sizeof(float));
+                assert(table->quotient != NULL);
+                for (unsigned v = 0; v <= denominator; v++) {
+                        table->quotient[v] = (float) v / denominator;
+                }
+                return table;
+        }
+
+        table->red = malloc(3 * values * sizeof(struct Contribution));
+        assert(table->red != NULL);
+        table->green = table->red + values;
+        table->blue = table->green + values;
+        for (unsigned v = 0; v <= denominator; v++) {
+                float q = (float) v / denominator;
+                table->red[v] = (struct Contribution) {
+                        0.299 * q, -0.168736 * q, 0.5 * q
+                };
+                table->green[v] = (struct Contribution) {
+                        0.587 * q, -(0.331264 * q), -(0.418688 * q)
+                };
+                table->blue[v] = (struct Contribution) {
+                        0.114 * q, 0.5 * q, -(0.081312 * q)
+                };
+        }
+
+        return table;
+}
+
+/*
+ * Name:       lookUp
+ * Purpose:    a private function that converts a single pixel with
+ *             whichever tier of table it has
+ * Parameters: const struct Color_table *table: the tables to use
+ *             const struct Pnm_rgb *pixel: the pixel to convert
+ * Return:     the pixel in component video color space
+ * Expects:    table and pixel to not be NULL
+ * Notes:      None
+ */
+static struct YPbPr_pixel lookUp(const struct Color_table *table,
+                                 const struct Pnm_rgb *pixel)
+{
+        if (table->quotient == NULL) {
+                return addContributions(table, pixel);
+        }
+        return multiplyQuotients(table, pixel);
+}
+
+/*
+ * Name:       addContributions
+ * Purpose:    a private function that converts a single pixel by adding
+ *             up the contributions of its color values
+ * Parameters: const struct Color_table *table: tables with contributions
+ *             const struct Pnm_rgb *pixel: the pixel to convert
+ * Return:     the pixel in component video color space
+ * Expects:    table and pixel to not be NULL
+ * Notes:      the sums are added in the order pixelToYPbPr() adds them
+ */
+static inline struct YPbPr_pixel
+addContributions(const struct Color_table *table, const struct Pnm_rgb *pixel)
+{
+        const struct Contribution *r = &table->red[pixel->red];
+        const struct Contribution *g = &table->green[pixel->green];
+        const struct Contribution *b = &table->blue[pixel->blue];
+
+        float Y = r->Y + g->Y + b->Y;
+        float Pb = r->Pb + g->Pb + b->Pb;
+        float Pr = r->Pr + g->Pr + b->Pr;
+
+        return (struct YPbPr_pixel) {
+                clamp(Y, 0, 1), clamp(Pb, -0.5, 0.5), clamp(Pr, -0.5, 0.5)
+        };
+}
+
+/*
+ * Name:       multiplyQuotients
+ * Purpose:    a private function that converts a single pixel from the
+ *             quotients of its color values
+ * Parameters: const struct Color_table *table: tables with quotients
+ *             const struct Pnm_rgb *pixel: the pixel to convert
+ * Return:     the pixel in component video color space
+ * Expects:    table and pixel to not be NULL
+ * Notes:      the same formulas as pixelToYPbPr(), minus its divides
+ */
+static inline struct YPbPr_pixel
+multiplyQuotients(const struct Color_table *table, const struct Pnm_rgb *pixel)
+{
+        float r = table->quotient[pixel->red];
+        float g = table->quotient[pixel->green];
+        float b = table->quotient[pixel->blue];
+
+        float Y = 0.299 * r + 0.587 * g + 0.114 * b;
+        float Pb = -0.168736 * r - 0.331264 * g + 0.5 * b;
+        float Pr = 0.5 * r - 0.418688 * g - 0.081312 * b;
+
+        return (struct YPbPr_pixel) {
+                clamp(Y, 0, 1), clamp(Pb, -0.5, 0.5), clamp(Pr, -0.5, 0.5)
+        };
+}
+
+/*
+ * Name:       clamp
+ * Purpose:    a private function that keeps a value within a range
+ * Parameters: float value: the value to clamp
+ *             float min, max: the ends of the range
+ * Return:     min if value is below it, max if value is above it, and
+ *             value otherwise
+ * Expects:    min to be at most max
+ * Notes:      the same as clamp() in convertColor.c
+ */
+static float clamp(float value, float min, float max)
+{
+        if (value < min) {
+                return min;
+        }
+        if (value > max) {
+                return max;
+        }
+
+        return value;
+}
@@ -0,0 +1,33 @@
+/**************************************************************
+ *                     colorTable.h
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the function declarations for colorTable.c,
+ *     which converts pixels from RGB to component video color space by
+ *     looking values up in tables built once for each maximum color value.
+ *     The results are exactly what pixelToYPbPr() in convertColor.c
+ *     returns for the same pixels.
+ *
+ **************************************************************/
+#ifndef COLOR_TABLE_H
+#define COLOR_TABLE_H
+
+#include "pnm.h"
+#include "helpers.h"
+
+struct Color_table;
+
+const struct Color_table *colorTable(unsigned denominator);
+struct YPbPr_pixel tableToYPbPr(const struct Color_table *table,
+                                const struct Pnm_rgb *pixel);
+void tableRowToYPbPr(const struct Color_table *table,
+                     const struct Pnm_rgb *pixels, struct YPbPr_pixel *out,
+                     int count);
+
+#endif
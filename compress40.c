@@ -22,8 +22,82 @@
 #include "a2methods.h"
 #include "a2blocked.h"
 #include "a2plain.h"
+#include "a2extended.h"
+#include "codeword.h"
+#include "options.h"
+#include "ppmStream.h"
+#include "inputSource.h"
+#include "parallel.h"
+#include "tiled.h"
+#include "outputTarget.h"
 #include "pnm.h"
 #include "assert.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct Options codecOptions = { .staged = false, .stream = false,
+                                 .threads = 1 };
+
+static const unsigned BANDS_PER_THREAD = 4;
+
+/*
+ * Name:       Band_closure
+ * Purpose:    Stores what every thread needs to encode or decode its bands
+ *             of an image
+ * Components: 
+ *             Pnm_ppm image: the image being compressed (encoding only)
+ *             unsigned width, height: the size of the image being
+ *             decompressed (decoding only)
+ *             unsigned char *bytes: the pixels of the image being
+ *             decompressed, as a raw PPM stores them (decoding only)
+ *             uint32_t *words: every code word of the image in row-major
+ *             order, width / 2 per row, or NULL when encoding straight into
+ *             out
+ *             unsigned char *out: where the code words are stored in the
+ *             mapped output file, or NULL (encoding only)
+ *             int bands: the number of bands
+ *             unsigned rowsPerBand: the number of rows of blocks in each
+ *             band (the last band may have fewer)
+ *             enum Engine engine: the arithmetic every band is done in
+ */
+struct Band_closure {
+        Pnm_ppm image;
+        unsigned width, height;
+        unsigned char *bytes;
+        uint32_t *words;
+        unsigned char *out;
+        int bands;
+        unsigned rowsPerBand;
+        enum Engine engine;
+};
+
+static void cropImage(Pnm_ppm image, struct Pnm_ppm *crop);
+static void compressStaged(Pnm_ppm image);
+static void compressFused(Pnm_ppm image);
+static void compressStream(FILE *input);
+static void compressBands(Pnm_ppm image);
+static void encodeBandTask(int band, void *cl);
+static void encodeRowPair(Pnm_ppm image, unsigned row, struct Pnm_rgb *copies,
+                          struct YPbPr_pixel *converted, uint32_t *words,
+                          enum Engine engine);
+static void decompressStaged(FILE *input, unsigned width, unsigned height,
+                             A2Methods_T methods);
+static void decompressFused(FILE *input, unsigned width,
+                            unsigned height);
+static void decompressStream(FILE *input, unsigned width,
+                             unsigned height);
+static void decompressRegion(FILE *input, unsigned width,
+                             unsigned height);
+static void decompressPreview(FILE *input, unsigned width,
+                              unsigned height);
+static void decompressBands(struct Input_source *input, unsigned width,
+                            unsigned height);
+static void decodeRowPairs(struct Input_source *input, unsigned width,
+                           unsigned height, enum Engine engine);
+static void decodeBandTask(int band, void *cl);
+static void startBands(struct Band_closure *cl, unsigned wordsHeight);
+static void bandRows(struct Band_closure *cl, int band, unsigned wordsHeight,
+                     unsigned *first, unsigned *last);
 
 /************************ compress40 ******************************
  *
@@ -42,8 +116,19 @@
  *         the file stored in input is a valid PPM with nonzero dimensions
  * Notes:
  *         Prints the compressed PPM to stdout in big-endian order
- *         Frees memory allocated for a A2Methods_UArray2 allocated in
- *         rgbToYPbPr(), packBlock(), quantizeData(), and packWord().
+ *         Compresses only codecOptions.region of the image if
+ *         codecOptions.hasRegion is set, through a view made by
+ *         cropImage(), so the crop is never copied; the region takes
+ *         priority over codecOptions.stream.
+ *         Prints a FORMAT_TILED image with compressTiled() if
+ *         codecOptions.tiled is set, reading the whole image first.
+ *         Otherwise streams the image two rows at a time if
+ *         codecOptions.stream is set, or reads the whole image and uses
+ *         the staged pipeline if codecOptions.staged is set, and the fused
+ *         single-pass kernel if not. Those three print the same bytes.
+ *         Writes to the file codecOptions.output instead of stdout if it
+ *         is set: the fused kernel stores its code words straight into
+ *         the mapped file, and the other paths print to it with stdio.
  *         Frees memory allocated for a PPM allocated in readInPPM()
  *         Will raise a CRE if input is NULL.
  *
@@ -51,27 +136,371 @@
 void compress40(FILE *input)
 {
         assert(input != NULL);
+        bool stream = codecOptions.stream && !codecOptions.tiled &&
+                      !codecOptions.hasRegion;
+        bool fused = !codecOptions.tiled && !stream && !codecOptions.staged;
+        if (codecOptions.output != NULL && !fused) {
+                redirectOutput(codecOptions.output);
+        }
+
+        if (stream) {
+                compressStream(input);
+                return;
+        }
+
         Pnm_ppm original = readInPPM(input);
+        struct Pnm_ppm crop;
+        Pnm_ppm image = original;
+        if (codecOptions.hasRegion) {
+                cropImage(original, &crop);
+                image = &crop;
+        }
+
+        if (codecOptions.tiled) {
+                compressTiled(image);
+        } else if (codecOptions.staged) {
+                compressStaged(image);
+        } else {
+                compressFused(image);
+        }
+
+        if (codecOptions.hasRegion) {
+                original->methods->free(&crop.pixels);
+        }
+        Pnm_ppmfree(&original);
+}
+
+/*
+ * Name:       cropImage
+ * Purpose:    Makes a view of the part of an image inside
+ *             codecOptions.region
+ * Parameters: Pnm_ppm image: the trimmed image
+ *             struct Pnm_ppm *crop: where the cropped image is stored
+ * Return:     None
+ * Expects:    image and crop to not be NULL, and the top-left corner of
+ *             the region to lie inside image
+ * Notes:      will CRE if either pointer is NULL or the region starts
+ *             outside image. As in decompressRegion(), a region running
+ *             past the right or bottom edge is cut off at the edge; its
+ *             width and height are then rounded down to even, as
+ *             readInPPM() trims an image. The corner may be odd.
+ *             crop->pixels is a view of image->pixels, which must be
+ *             freed with image->methods->free before image is.
+ */
+static void cropImage(Pnm_ppm image, struct Pnm_ppm *crop)
+{
+        assert(image != NULL && crop != NULL);
 
-        A2Methods_UArray2 YPbPr_pixels = rgbToYPbPr(
-                original->pixels, original->denominator, original->methods);
+        struct Region region = codecOptions.region;
+        assert(region.x < image->width && region.y < image->height);
+        if (region.width > image->width - region.x) {
+                region.width = image->width - region.x;
+        }
+        if (region.height > image->height - region.y) {
+                region.height = image->height - region.y;
+        }
+        region.width -= region.width % 2;
+        region.height -= region.height % 2;
+
+        crop->width = region.width;
+        crop->height = region.height;
+        crop->denominator = image->denominator;
+        crop->methods = image->methods;
+        crop->pixels = A2Extended(image->methods)->view(
+                image->pixels, region.x, region.y, region.width,
+                region.height);
+}
+
+/*
+ * Name:       compressStaged
+ * Purpose:    Compresses an image by running each stage of the compression
+ *             over the whole image before starting the next one, and prints
+ *             it to stdout
+ * Parameters: Pnm_ppm image: the trimmed image to compress
+ * Return:     None
+ * Expects:    image to not be NULL and to have even dimensions
+ * Notes:      Frees memory allocated for a A2Methods_UArray2 allocated in
+ *             rgbToBlock(), quantizeData(), and packWord().
+ *             rgbToBlock() converts and packs the pixels in one stage, so
+ *             the image is never stored in component video color space.
+ *             Prints the same bytes as compressFused(), so "make check"
+ *             runs both against the same recorded cksums.
+ */
+static void compressStaged(Pnm_ppm image)
+{
+        assert(image != NULL);
+        int threads = codecOptions.threads;
 
-        A2Methods_UArray2 blockedPixels =
-                packBlock(YPbPr_pixels, original->methods);
+        A2Methods_UArray2 blockedPixels = rgbToBlock(
+                image->pixels, image->denominator, image->methods, threads);
 
         A2Methods_UArray2 quantizedPix =
-                quantizeData(blockedPixels, original->methods);
+                quantizeData(blockedPixels, image->methods, threads);
 
-        A2Methods_UArray2 packedPix = packWord(quantizedPix, original->methods);
+        A2Methods_UArray2 packedPix =
+                packWord(quantizedPix, image->methods, threads);
 
-        printCompressedImage(packedPix, original->methods);
+        printCompressedImage(packedPix, image->methods);
 
-        original->methods->free(&YPbPr_pixels);
-        original->methods->free(&blockedPixels);
-        original->methods->free(&quantizedPix);
-        original->methods->free(&packedPix);
+        image->methods->free(&blockedPixels);
+        image->methods->free(&quantizedPix);
+        image->methods->free(&packedPix);
+}
 
-        Pnm_ppmfree(&original);
+/*
+ * Name:       compressFused
+ * Purpose:    Compresses an image in one pass, turning each 2x2 block of
+ *             pixels straight into a code word and printing it to stdout
+ * Parameters: Pnm_ppm image: the trimmed image to compress
+ * Return:     None
+ * Expects:    image to not be NULL and to have even dimensions
+ * Notes:      Allocates and frees one row of code words, which is printed
+ *             as soon as it is encoded, and the buffers encodeRowPair()
+ *             needs
+ *             Hands the work to compressBands() if codecOptions.threads is
+ *             more than 1 or codecOptions.output is set
+ */
+static void compressFused(Pnm_ppm image)
+{
+        assert(image != NULL);
+        if (codecOptions.threads > 1 || codecOptions.output != NULL) {
+                compressBands(image);
+                return;
+        }
+
+        size_t rowPairSize = 2 * (size_t) image->width + 1;
+        struct Pnm_rgb *copies = malloc(rowPairSize * sizeof(struct Pnm_rgb));
+        struct YPbPr_pixel *converted =
+                malloc(rowPairSize * sizeof(struct YPbPr_pixel));
+        uint32_t *words = malloc((image->width / 2 + 1) * sizeof(uint32_t));
+        assert(copies != NULL && converted != NULL && words != NULL);
+        enum Engine engine = optionsEngine(&codecOptions);
+
+        printCompressedHeader(FORMAT_ROWS, image->width, image->height);
+
+        for (unsigned row = 0; row < image->height; row += 2) {
+                encodeRowPair(image, row, copies, converted, words, engine);
+                printWords(words, image->width / 2);
+        }
+
+        free(copies);
+        free(converted);
+        free(words);
+}
+
+/*
+ * Name:       compressBands
+ * Purpose:    Compresses an image by splitting its rows of blocks into
+ *             bands that are encoded on codecOptions.threads threads, then
+ *             prints the code words to stdout or to codecOptions.output
+ * Parameters: Pnm_ppm image: the trimmed image to compress
+ * Return:     None
+ * Expects:    image to not be NULL and to have even dimensions
+ * Notes:      Allocates and frees an array holding every code word, since
+ *             bands may finish out of order. With codecOptions.output set,
+ *             the output file is mapped instead and each band stores its
+ *             code words straight into its own part of the file, unless
+ *             it cannot be mapped (/dev/null, a pipe), in which case it
+ *             is printed to like stdout.
+ */
+static void compressBands(Pnm_ppm image)
+{
+        assert(image != NULL);
+        unsigned wordsWidth = image->width / 2;
+        unsigned wordsHeight = image->height / 2;
+        size_t wordCount = (size_t) wordsWidth * wordsHeight;
+
+        struct Band_closure cl = { .image = image,
+                                   .engine = optionsEngine(&codecOptions) };
+        startBands(&cl, wordsHeight);
+
+        struct Output_target target;
+        bool mapped = false;
+        if (codecOptions.output != NULL) {
+                char header[64];
+                size_t headerLength =
+                        formatCompressedHeader(header, sizeof(header),
+                                               FORMAT_ROWS, image->width,
+                                               image->height);
+                mapped = openOutputTarget(codecOptions.output,
+                                          headerLength + wordCount * 4,
+                                          &target);
+                if (mapped) {
+                        memcpy(target.bytes, header, headerLength);
+                        cl.out = target.bytes + headerLength;
+                }
+        }
+        if (!mapped) {
+                cl.words = malloc(wordCount * sizeof(uint32_t));
+                assert(cl.words != NULL || wordCount == 0);
+        }
+
+        runParallel(codecOptions.threads, cl.bands, encodeBandTask, &cl);
+
+        if (mapped) {
+                closeOutputTarget(&target);
+                return;
+        }
+
+        printCompressedHeader(FORMAT_ROWS, image->width, image->height);
+        printWords(cl.words, wordCount);
+
+        free(cl.words);
+}
+
+/*
+ * Name:       encodeBandTask
+ * Purpose:    Encodes every block in one band of the image into its code
+ *             word. Run once per band by runParallel().
+ * Parameters: int band: the number of the band to encode
+ *             void *cl: a pointer to a Band_closure holding the image and
+ *             the array of code words or the mapped output
+ * Return:     None
+ * Expects:    cl to not be NULL and band to be less than its number of bands
+ * Notes:      only writes the code words of its own band
+ *             When storing into the mapped output, each row is encoded
+ *             into a row buffer and then stored in big-endian order.
+ *             Reports a CRE to runParallel() if its buffers cannot be
+ *             allocated
+ */
+static void encodeBandTask(int band, void *cl)
+{
+        struct Band_closure *closure = cl;
+        Pnm_ppm image = closure->image;
+        unsigned wordsWidth = image->width / 2;
+        unsigned first, last;
+        bandRows(closure, band, image->height / 2, &first, &last);
+
+        size_t rowPairSize = 2 * (size_t) image->width + 1;
+        struct Pnm_rgb *copies = malloc(rowPairSize * sizeof(struct Pnm_rgb));
+        struct YPbPr_pixel *converted =
+                malloc(rowPairSize * sizeof(struct YPbPr_pixel));
+        uint32_t *rowWords = NULL;
+        if (closure->out != NULL) {
+                rowWords = malloc((wordsWidth + 1) * sizeof(uint32_t));
+        }
+        if (copies == NULL || converted == NULL ||
+            (closure->out != NULL && rowWords == NULL)) {
+                free(copies);
+                free(converted);
+                free(rowWords);
+                TASK_RAISE(Assert_Failed);
+                return;
+        }
+
+        for (unsigned wordRow = first; wordRow < last; wordRow++) {
+                size_t start = (size_t) wordRow * wordsWidth;
+                uint32_t *words = closure->out != NULL ? rowWords
+                                                       : closure->words + start;
+                encodeRowPair(image, wordRow * 2, copies, converted, words,
+                              closure->engine);
+                if (closure->out != NULL) {
+                        storeWords(closure->out + start * 4, words,
+                                   wordsWidth);
+                }
+        }
+
+        free(copies);
+        free(converted);
+        free(rowWords);
+}
+
+/*
+ * Name:       encodeRowPair
+ * Purpose:    Encodes one row of blocks of an image into its code words
+ * Parameters: Pnm_ppm image: the trimmed image to compress
+ *             unsigned row: the top row of pixels of the blocks
+ *             struct Pnm_rgb *copies: room for two rows of pixels, used if
+ *             the image's rows are not stored as arrays
+ *             struct YPbPr_pixel *converted: room for two rows of pixels in
+ *             component video color space
+ *             uint32_t *words: where the width / 2 code words are stored
+ *             enum Engine engine: the arithmetic to encode in
+ * Return:     None
+ * Expects:    image, copies, converted, and words to not be NULL and row to
+ *             be an even row of the image
+ * Notes:      converts whole rows of pixels at a time with rgbRowsToWords()
+ */
+static void encodeRowPair(Pnm_ppm image, unsigned row, struct Pnm_rgb *copies,
+                          struct YPbPr_pixel *converted, uint32_t *words,
+                          enum Engine engine)
+{
+        assert(image != NULL);
+        const struct Pnm_rgb *top = imagePixels(image, 0, row, image->width,
+                                                copies);
+        const struct Pnm_rgb *bottom = imagePixels(image, 0, row + 1,
+                                                   image->width,
+                                                   copies + image->width);
+        rgbRowsToWords(top, bottom, image->width / 2, image->denominator,
+                       converted, words, engine);
+}
+
+/*
+ * Name:       compressStream
+ * Purpose:    Compresses a PPM two rows at a time, printing each row of
+ *             code words to stdout as soon as it is encoded
+ * Parameters: FILE *input: a pointer to an open file stream beginning at the
+ *             start of a raw (P6) or plain (P3) PPM
+ * Return:     None
+ * Expects:    input to not be NULL
+ * Notes:      Only two rows of pixels are held in memory at once, so the
+ *             image may be bigger than the memory available.
+ *             The last row or column of an odd-sized image is dropped, just
+ *             like readInPPM() does.
+ *             Raises Pnm_Badformat if the input is not a complete PPM
+ */
+static void compressStream(FILE *input)
+{
+        assert(input != NULL);
+        unsigned width, height, denominator;
+        enum PPM_format format =
+                readPPMHeader(input, &width, &height, &denominator);
+
+        unsigned trimmedWidth = width - (width % 2);
+        unsigned trimmedHeight = height - (height % 2);
+
+        Pnm_rgb top = malloc((trimmedWidth + 1) * sizeof(struct Pnm_rgb));
+        Pnm_rgb bottom = malloc((trimmedWidth + 1) * sizeof(struct Pnm_rgb));
+        struct YPbPr_pixel *converted =
+                malloc((2 * (size_t) trimmedWidth + 1) *
+                       sizeof(struct YPbPr_pixel));
+        uint32_t *words = malloc((trimmedWidth / 2 + 1) * sizeof(uint32_t));
+        assert(top != NULL && bottom != NULL && words != NULL);
+        assert(converted != NULL);
+        enum Engine engine = optionsEngine(&codecOptions);
+
+        struct Input_source source;
+        if (format == PPM_RAW) {
+                openInputSource(input, &source);
+        }
+
+        printCompressedHeader(FORMAT_ROWS, trimmedWidth, trimmedHeight);
+
+        for (unsigned row = 0; row < trimmedHeight; row += 2) {
+                if (format == PPM_RAW) {
+                        readPPMRow(&source, width, trimmedWidth, denominator,
+                                   top);
+                        readPPMRow(&source, width, trimmedWidth, denominator,
+                                   bottom);
+                } else {
+                        readPlainPPMRow(input, width, trimmedWidth,
+                                        denominator, top);
+                        readPlainPPMRow(input, width, trimmedWidth,
+                                        denominator, bottom);
+                }
+
+                rgbRowsToWords(top, bottom, trimmedWidth / 2, denominator,
+                               converted, words, engine);
+                printWords(words, trimmedWidth / 2);
+        }
+
+        if (format == PPM_RAW) {
+                closeInputSource(&source);
+        }
+        free(top);
+        free(bottom);
+        free(converted);
+        free(words);
 }
 
 /************************ decompress40 ******************************
@@ -90,28 +519,93 @@ void compress40(FILE *input)
  *         order
  * Notes:
  *         Prints the decompressed PPM to stdout
- *         Frees memory allocated for a A2Methods_UArray2 allocated in
- *         readInCompressed(), unpackWord(), dequantizedPix(), unblockedPixels(),
- *         and decompressedImage().
+ *         Reads both FORMAT_ROWS and FORMAT_TILED images; a tiled image is
+ *         always decoded one row of tiles at a time by decompressTiled().
+ *         Prints only codecOptions.region of the image if
+ *         codecOptions.hasRegion is set, and a half-resolution preview if
+ *         codecOptions.preview is set. Otherwise streams the image one
+ *         row of code words at a time if codecOptions.stream is set,
+ *         uses the staged pipeline if codecOptions.staged is set, and the
+ *         fused single-pass kernel if not. All three print the same bytes.
+ *         Writes to the file codecOptions.output instead of stdout if it
+ *         is set: the fused kernel stores its pixels straight into the
+ *         mapped file, and the other paths print to it with stdio.
+ *         decompressTiled() opens the file itself, once it has checked
+ *         that the tiles it needs are there.
  *         Will raise a CRE if input is NULL.
  *
  ************************************************************/
 void decompress40(FILE *input)
 {
+        assert(input != NULL);
         A2Methods_T methods = uarray2_methods_plain;
         assert(methods != NULL);
 
-        A2Methods_UArray2 compressedImage = readInCompressed(input, methods);
+        unsigned width, height;
+        enum Compressed_format format =
+                readCompressedHeader(input, &width, &height);
+
+        bool fused = format == FORMAT_ROWS && !codecOptions.hasRegion &&
+                     !codecOptions.preview && !codecOptions.stream &&
+                     !codecOptions.staged;
+        if (codecOptions.output != NULL && !fused &&
+            format != FORMAT_TILED) {
+                redirectOutput(codecOptions.output);
+        }
+
+        if (format == FORMAT_TILED) {
+                decompressTiled(input, width, height);
+        } else if (codecOptions.hasRegion) {
+                decompressRegion(input, width, height);
+        } else if (codecOptions.preview) {
+                decompressPreview(input, width, height);
+        } else if (codecOptions.stream) {
+                decompressStream(input, width, height);
+        } else if (codecOptions.staged) {
+                decompressStaged(input, width, height, methods);
+        } else {
+                decompressFused(input, width, height);
+        }
+}
+
+/*
+ * Name:       decompressStaged
+ * Purpose:    Decompresses an image by running each stage of the
+ *             decompression over the whole image before starting the next
+ *             one, and prints it to stdout as a PPM
+ * Parameters: FILE *input: a pointer to an open file stream positioned just
+ *             after the size line of a FORMAT_ROWS header
+ *             unsigned width: the width of the image from the header
+ *             unsigned height: the height of the image from the header
+ *             A2Methods_T methods: the methods used for every stage's array
+ * Return:     None
+ * Expects:    input and methods to not be NULL
+ * Notes:      Frees memory allocated for a A2Methods_UArray2 allocated in
+ *             readCompressedWords(), unpackWord(), dequantizedPix(),
+ *             unblockedPixels(), and decompressedImage().
+ *             Prints the same bytes as decompressFused(), so "make check"
+ *             runs both against the same recorded cksums.
+ */
+static void decompressStaged(FILE *input, unsigned width, unsigned height,
+                             A2Methods_T methods)
+{
+        assert(input != NULL && methods != NULL);
+        int threads = codecOptions.threads;
+
+        A2Methods_UArray2 compressedImage =
+                readCompressedWords(input, width, height, methods);
 
-        A2Methods_UArray2 depackedPix = unpackWord(compressedImage, methods);
+        A2Methods_UArray2 depackedPix =
+                unpackWord(compressedImage, methods, threads);
 
-        A2Methods_UArray2 dequantizedPix = dequantizeData(depackedPix, methods);
+        A2Methods_UArray2 dequantizedPix =
+                dequantizeData(depackedPix, methods, threads);
 
         A2Methods_UArray2 unblockedPixels =
-                unpackBlock(dequantizedPix, methods);
+                unpackBlock(dequantizedPix, methods, threads);
 
         A2Methods_UArray2 decompressedImage =
-                YPbPrToRGB(unblockedPixels, 255, methods);
+                YPbPrToRGB(unblockedPixels, 255, methods, threads);
 
         struct Pnm_ppm pixmap = { .width = methods->width(decompressedImage),
                                   .height = methods->height(decompressedImage),
@@ -119,11 +613,452 @@ void decompress40(FILE *input)
                                   .pixels = decompressedImage,
                                   .methods = methods };
 
-        Pnm_ppmwrite(stdout, &pixmap);
+        printPPM(stdout, &pixmap);
 
         methods->free(&compressedImage);
         methods->free(&depackedPix);
         methods->free(&dequantizedPix);
         methods->free(&unblockedPixels);
         methods->free(&decompressedImage);
-}
\ No newline at end of file
+}
+
+/*
+ * Name:       decompressFused
+ * Purpose:    Decompresses an image in one pass, turning each code word
+ *             straight into the bytes of its four pixels, and prints it to
+ *             stdout as a PPM
+ * Parameters: FILE *input: a pointer to an open file stream positioned just
+ *             after the size line of a FORMAT_ROWS header
+ *             unsigned width: the width of the image from the header
+ *             unsigned height: the height of the image from the header
+ * Return:     None
+ * Expects:    input to not be NULL
+ * Notes:      will CRE, before printing anything, if input is too short
+ *             to hold every code word
+ *             No image is allocated: each pair of rows is decoded into a
+ *             byte buffer that is printed with one fwrite()
+ *             Hands the decoding to decompressBands() if
+ *             codecOptions.threads is more than 1 or codecOptions.output
+ *             is set, or if the length of input cannot be known up front
+ *             (a pipe); decompressBands() reads every code word before it
+ *             prints
+ */
+static void decompressFused(FILE *input, unsigned width,
+                            unsigned height)
+{
+        assert(input != NULL);
+
+        struct Input_source source;
+        openInputSource(input, &source);
+        size_t wordBytes = (size_t) (width / 2) * (height / 2) * 4;
+        size_t left;
+
+        if (codecOptions.threads > 1 || codecOptions.output != NULL ||
+            !inputBytesLeft(&source, &left)) {
+                decompressBands(&source, width, height);
+        } else {
+                assert(left >= wordBytes);
+                printPPMHeader(stdout, width, height, 255);
+                decodeRowPairs(&source, width, height,
+                               optionsEngine(&codecOptions));
+        }
+
+        closeInputSource(&source);
+}
+
+/*
+ * Name:       decompressBands
+ * Purpose:    Reads in every code word of a compressed image, decodes them
+ *             in bands of rows of blocks on codecOptions.threads threads,
+ *             and prints the image to stdout or to codecOptions.output
+ * Parameters: struct Input_source *input: the source positioned at the
+ *             first code word
+ *             unsigned width: the width of the image from the header
+ *             unsigned height: the height of the image from the header
+ * Return:     None
+ * Expects:    input to not be NULL
+ * Notes:      Allocates and frees an array holding every code word and a
+ *             buffer holding every pixel byte, which is printed with one
+ *             fwrite(). With codecOptions.output set, the output file is
+ *             mapped and used as that buffer, so each band stores its
+ *             pixels straight into its own part of the file, unless it
+ *             cannot be mapped (/dev/null, a pipe), in which case it is
+ *             printed to like stdout.
+ *             Every code word is read before anything is printed or the
+ *             output file is opened, so a short input raises a CRE with
+ *             nothing written.
+ */
+static void decompressBands(struct Input_source *input, unsigned width,
+                            unsigned height)
+{
+        assert(input != NULL);
+        size_t wordCount = (size_t) (width / 2) * (height / 2);
+        size_t byteCount = (size_t) width * height * 3;
+
+        struct Band_closure cl = { .width = width,
+                                   .height = height,
+                                   .engine = optionsEngine(&codecOptions) };
+        startBands(&cl, height / 2);
+        cl.words = malloc(wordCount * sizeof(uint32_t));
+        assert(cl.words != NULL || wordCount == 0);
+        readWords(input, cl.words, wordCount);
+
+        struct Output_target target;
+        bool mapped = false;
+        if (codecOptions.output != NULL) {
+                char header[64];
+                size_t headerLength = formatPPMHeader(header, sizeof(header),
+                                                      width, height, 255);
+                mapped = openOutputTarget(codecOptions.output,
+                                          headerLength + byteCount, &target);
+                if (mapped) {
+                        memcpy(target.bytes, header, headerLength);
+                        cl.bytes = target.bytes + headerLength;
+                }
+        }
+        if (!mapped) {
+                cl.bytes = malloc(byteCount);
+                assert(cl.bytes != NULL || byteCount == 0);
+        }
+
+        runParallel(codecOptions.threads, cl.bands, decodeBandTask, &cl);
+
+        if (mapped) {
+                closeOutputTarget(&target);
+        } else {
+                printPPMHeader(stdout, width, height, 255);
+                size_t written = fwrite(cl.bytes, 1, byteCount, stdout);
+                assert(written == byteCount);
+                free(cl.bytes);
+        }
+
+        free(cl.words);
+}
+
+/*
+ * Name:       decodeBandTask
+ * Purpose:    Decodes the code words of one band into the pixel bytes of
+ *             the output image. Run once per band by runParallel().
+ * Parameters: int band: the number of the band to decode
+ *             void *cl: a pointer to a Band_closure holding the output
+ *             bytes and the array of code words
+ * Return:     None
+ * Expects:    cl to not be NULL and band to be less than its number of bands
+ * Notes:      only writes the bytes of its own band
+ *             Reports a CRE to runParallel() if its buffer cannot be
+ *             allocated
+ */
+static void decodeBandTask(int band, void *cl)
+{
+        struct Band_closure *closure = cl;
+        unsigned width = closure->width;
+        unsigned wordsWidth = width / 2;
+        size_t rowBytes = (size_t) width * 3;
+        unsigned first, last;
+        bandRows(closure, band, closure->height / 2, &first, &last);
+
+        struct YPbPr_pixel *converted =
+                malloc((2 * (size_t) width + 1) * sizeof(struct YPbPr_pixel));
+        if (converted == NULL) {
+                TASK_RAISE(Assert_Failed);
+                return;
+        }
+
+        for (unsigned wordRow = first; wordRow < last; wordRow++) {
+                uint32_t *words =
+                        closure->words + (size_t) wordRow * wordsWidth;
+                unsigned char *top = closure->bytes + 2 * wordRow * rowBytes;
+                wordsToBytes(words, wordsWidth, converted, top,
+                             top + rowBytes, closure->engine);
+        }
+
+        free(converted);
+}
+
+/*
+ * Name:       startBands
+ * Purpose:    Splits the rows of blocks of an image into bands, a few more
+ *             bands than there are threads so that a slow band does not
+ *             leave the other threads idle
+ * Parameters: struct Band_closure *cl: where the number of bands and the
+ *             rows per band are stored
+ *             unsigned wordsHeight: the number of rows of blocks
+ * Return:     None
+ * Expects:    cl to not be NULL and codecOptions.threads to be between 1
+ *             and MAX_THREADS
+ * Notes:      will CRE if cl is NULL or the number of threads is out of
+ *             range
+ *             There is at least one band unless wordsHeight is 0.
+ */
+static void startBands(struct Band_closure *cl, unsigned wordsHeight)
+{
+        assert(cl != NULL);
+        assert(codecOptions.threads >= 1 &&
+               codecOptions.threads <= MAX_THREADS);
+        unsigned bands = codecOptions.threads * BANDS_PER_THREAD;
+        if (bands > wordsHeight) {
+                bands = wordsHeight;
+        }
+
+        cl->bands = 0;
+        cl->rowsPerBand = 0;
+        if (bands == 0) {
+                return;
+        }
+
+        cl->rowsPerBand = (wordsHeight + bands - 1) / bands;
+        cl->bands = (wordsHeight + cl->rowsPerBand - 1) / cl->rowsPerBand;
+        assert(cl->bands > 0);
+}
+
+/*
+ * Name:       bandRows
+ * Purpose:    Finds the rows of blocks that belong to a band
+ * Parameters: struct Band_closure *cl: holds the rows per band
+ *             int band: the number of the band
+ *             unsigned wordsHeight: the number of rows of blocks
+ *             unsigned *first: where the first row of the band is stored
+ *             unsigned *last: where one past the last row is stored
+ * Return:     None
+ * Expects:    cl, first, and last to not be NULL
+ * Notes:      None
+ */
+static void bandRows(struct Band_closure *cl, int band, unsigned wordsHeight,
+                     unsigned *first, unsigned *last)
+{
+        assert(cl != NULL && first != NULL && last != NULL);
+        *first = band * cl->rowsPerBand;
+        *last = *first + cl->rowsPerBand;
+        if (*last > wordsHeight) {
+                *last = wordsHeight;
+        }
+}
+
+/*
+ * Name:       decompressStream
+ * Purpose:    Decompresses an image one row of code words at a time,
+ *             printing the two rows of pixels each one decodes to as soon as
+ *             they are ready
+ * Parameters: FILE *input: a pointer to an open file stream positioned just
+ *             after the size line of a FORMAT_ROWS header
+ *             unsigned width: the width of the image from the header
+ *             unsigned height: the height of the image from the header
+ * Return:     None
+ * Expects:    input to not be NULL
+ * Notes:      The PPM header is printed and flushed before any code word is
+ *             read, and only two rows of pixels are held in memory at once,
+ *             no matter how tall the image is.
+ */
+static void decompressStream(FILE *input, unsigned width,
+                             unsigned height)
+{
+        assert(input != NULL);
+
+        struct Input_source source;
+        openInputSource(input, &source);
+
+        printPPMHeader(stdout, width, height, 255);
+        fflush(stdout);
+
+        decodeRowPairs(&source, width, height, optionsEngine(&codecOptions));
+
+        closeInputSource(&source);
+}
+
+/*
+ * Name:       decompressRegion
+ * Purpose:    Decompresses only codecOptions.region of an image and prints
+ *             it to stdout as a PPM
+ * Parameters: FILE *input: a pointer to an open file stream positioned just
+ *             after the size line of a FORMAT_ROWS header
+ *             unsigned width: the width of the image from the header
+ *             unsigned height: the height of the image from the header
+ * Return:     None
+ * Expects:    input to not be NULL and the top-left corner of the region to
+ *             lie inside the image
+ * Notes:      will CRE if the region starts outside the image. A region
+ *             running past the right or bottom edge is cut off at the edge.
+ *             Each code word sits at an offset computed from its block's
+ *             column and row, so when input can be read at any offset only
+ *             the code words of the blocks covering the region are read,
+ *             with one pread() per row of blocks, after checking that the
+ *             last of them is there before printing anything. A pipe is
+ *             read in order up to the last row of blocks needed instead.
+ */
+static void decompressRegion(FILE *input, unsigned width,
+                             unsigned height)
+{
+        assert(input != NULL);
+
+        struct Region region = codecOptions.region;
+        assert(region.x < width && region.y < height);
+        if (region.width > width - region.x) {
+                region.width = width - region.x;
+        }
+        if (region.height > height - region.y) {
+                region.height = height - region.y;
+        }
+
+        unsigned wordsWidth = width / 2;
+        unsigned firstCol = region.x / 2;
+        unsigned blockCols = (region.x + region.width + 1) / 2 - firstCol;
+        unsigned firstRow = region.y / 2;
+        unsigned endRow = (region.y + region.height + 1) / 2;
+
+        size_t rowBytes = (size_t) blockCols * 6;
+        size_t regionBytes = (size_t) region.width * 3;
+        size_t skipBytes = (size_t) (region.x - firstCol * 2) * 3;
+        unsigned char *bytes = malloc(2 * rowBytes);
+        struct YPbPr_pixel *converted =
+                malloc(4 * (size_t) blockCols * sizeof(struct YPbPr_pixel));
+        uint32_t *words = malloc(wordsWidth * sizeof(uint32_t));
+        assert(bytes != NULL && converted != NULL && words != NULL);
+        enum Engine engine = optionsEngine(&codecOptions);
+
+        off_t start = ftello(input);
+        struct Input_source source;
+        if (start != -1 && endRow > firstRow) {
+                /* each code word is stored in 4 bytes */
+                off_t last = (off_t) (endRow - 1) * wordsWidth + firstCol +
+                             blockCols - 1;
+                bool read = readWordsAt(input, start + last * 4, words, 1);
+                assert(read);
+        }
+        if (start == -1) {
+                openInputSource(input, &source);
+                for (unsigned row = 0; row < firstRow; row++) {
+                        readWords(&source, words, wordsWidth);
+                }
+        }
+
+        printPPMHeader(stdout, region.width, region.height, 255);
+        for (unsigned row = firstRow; row < endRow; row++) {
+                uint32_t *rowWords = words;
+                if (start == -1) {
+                        readWords(&source, words, wordsWidth);
+                        rowWords += firstCol;
+                } else {
+                        /* each code word is stored in 4 bytes */
+                        off_t first = (off_t) row * wordsWidth + firstCol;
+                        bool read = readWordsAt(input, start + first * 4,
+                                                words, blockCols);
+                        assert(read);
+                }
+
+                wordsToBytes(rowWords, blockCols, converted, bytes,
+                             bytes + rowBytes, engine);
+
+                for (unsigned half = 0; half < 2; half++) {
+                        unsigned pixelRow = row * 2 + half;
+                        if (pixelRow < region.y ||
+                            pixelRow >= region.y + region.height) {
+                                continue;
+                        }
+                        size_t written = fwrite(bytes + half * rowBytes +
+                                                        skipBytes,
+                                                1, regionBytes, stdout);
+                        assert(written == regionBytes);
+                }
+        }
+
+        if (start == -1) {
+                closeInputSource(&source);
+        }
+        free(bytes);
+        free(converted);
+        free(words);
+}
+
+/*
+ * Name:       decompressPreview
+ * Purpose:    Decompresses an image at half its width and height, one pixel
+ *             per code word, and prints it to stdout as a PPM
+ * Parameters: FILE *input: a pointer to an open file stream positioned just
+ *             after the size line of a FORMAT_ROWS header
+ *             unsigned width: the width of the image from the header
+ *             unsigned height: the height of the image from the header
+ * Return:     None
+ * Expects:    input to not be NULL
+ * Notes:      Each pixel is the mean color of its block (a, avgPb, and
+ *             avgPr), so b, c, and d are never dequantized and the inverse
+ *             DCT is skipped. Reads and prints one row of code words at a
+ *             time. will CRE, before printing anything, if a mapped input
+ *             is too short to hold every code word.
+ */
+static void decompressPreview(FILE *input, unsigned width,
+                              unsigned height)
+{
+        assert(input != NULL);
+        unsigned wordsWidth = width / 2;
+        unsigned wordsHeight = height / 2;
+
+        size_t rowBytes = (size_t) wordsWidth * 3;
+        unsigned char *bytes = malloc(rowBytes + 1);
+        struct YPbPr_pixel *converted =
+                malloc((wordsWidth + 1) * sizeof(struct YPbPr_pixel));
+        uint32_t *words = malloc((wordsWidth + 1) * sizeof(uint32_t));
+        assert(bytes != NULL && converted != NULL && words != NULL);
+
+        enum Engine engine = optionsEngine(&codecOptions);
+
+        struct Input_source source;
+        openInputSource(input, &source);
+        size_t left;
+        if (inputBytesLeft(&source, &left)) {
+                assert(left >= (size_t) wordsWidth * wordsHeight * 4);
+        }
+
+        printPPMHeader(stdout, wordsWidth, wordsHeight, 255);
+        for (unsigned row = 0; row < wordsHeight; row++) {
+                readWords(&source, words, wordsWidth);
+                wordsToPreviewBytes(words, wordsWidth, converted, bytes,
+                                    engine);
+
+                size_t written = fwrite(bytes, 1, rowBytes, stdout);
+                assert(written == rowBytes);
+        }
+
+        closeInputSource(&source);
+        free(bytes);
+        free(converted);
+        free(words);
+}
+
+/*
+ * Name:       decodeRowPairs
+ * Purpose:    Reads a compressed image one row of code words at a time and
+ *             prints the two rows of pixels each one decodes to
+ * Parameters: struct Input_source *input: the source positioned at the
+ *             first code word
+ *             unsigned width: the width of the image from the header
+ *             unsigned height: the height of the image from the header
+ *             enum Engine engine: the arithmetic to decode in
+ * Return:     None
+ * Expects:    input to not be NULL and the PPM header to be printed already
+ * Notes:      The code words are turned straight into the bytes of a raw
+ *             PPM, so each pair of rows is printed with a single fwrite()
+ */
+static void decodeRowPairs(struct Input_source *input, unsigned width,
+                           unsigned height, enum Engine engine)
+{
+        assert(input != NULL);
+        size_t rowBytes = (size_t) width * 3;
+        unsigned char *bytes = malloc(2 * rowBytes + 1);
+        struct YPbPr_pixel *converted =
+                malloc((2 * (size_t) width + 1) * sizeof(struct YPbPr_pixel));
+        uint32_t *words = malloc((width / 2 + 1) * sizeof(uint32_t));
+        assert(bytes != NULL && converted != NULL && words != NULL);
+
+        for (unsigned row = 0; row < height; row += 2) {
+                readWords(input, words, width / 2);
+                wordsToBytes(words, width / 2, converted, bytes,
+                             bytes + rowBytes, engine);
+
+                size_t written = fwrite(bytes, 1, 2 * rowBytes, stdout);
+                assert(written == 2 * rowBytes);
+        }
+
+        free(bytes);
+        free(converted);
+        free(words);
+}
@@ -8,64 +8,23 @@
  *
  *     summary:
  *
- *     This file contains the rgbToYPbPr() and YPbPrToRGB() functions,
- *     which transform each pixel from RGB to component video color space
- *     (and vice versa). Also contains helper functions to do this.
+ *     This file contains pixelToYPbPr(), which transforms a pixel from RGB
+ *     to component video color space, and the YPbPrToRGB() function, which
+ *     transforms each pixel of an image back. Also contains helper
+ *     functions to do this.
  *
  **************************************************************/
 #include "convertColor.h"
+#include "colorKernel.h"
+#include "colorTable.h"
 #include "a2methods.h"
+#include "a2extended.h"
 #include "assert.h"
 #include <stdlib.h>
 #include <math.h>
 
 static float clamp(float value, float min, float max);
 
-/************************ rgbToYPbPr ******************************
- *
- * Converts each pixel of an image from RGB color space into component 
- * video color space. Stores these pixels in a A2Methods_UArray2 that will be 
- * returned.
- *
- * Parameters:
- *        A2Methods_UArray2 original: a pointer to a UArray2 storing 
- *        Pnm_rgb structs, which represents a pixels in RGB color space
- *        const struct A2Methods_T *methods: A pointer to a A2Methods_T struct
- *        that contains pointers to functions on can use on a UArray2
- *        unsigned denominator: an unsigned integer representing the
- *        maximum color value of the PPM
- *
- * Return: a pointer to a newly allocated A2Methods_UArray2 struct storing
- *         YPbPr_pixel structs representing the pixels from the original
- *         in the component video color space.
- *
- * Expects
- *         original and methods to not be NULL
- *         the pixels stored in original to be in the RGB color space
- * Notes:
- *         Allocates memory for a A2Methods_UArray2 struct (destination) that
- *         the caller is responsible for freeing using methods->free()
- *         Will raise a CRE if original or methods is NULL or if
- *         methods->new() fails.
- *
- ************************************************************/
-A2Methods_UArray2 rgbToYPbPr(A2Methods_UArray2 original, unsigned denominator,
-                             const struct A2Methods_T *methods)
-{
-        assert(original != NULL && methods != NULL);
-        A2Methods_UArray2 destination = methods->new(
-                methods->width(original), methods->height(original),
-                sizeof(struct YPbPr_pixel));
-
-        struct Closure cl = { .array = original,
-                              .methods = methods,
-                              .denominator = denominator };
-
-        methods->map_default(destination, convertYbPbPrApply, &cl);
-
-        return destination;
-}
-
 /*
  * Name:       pixelToYPbPr
  * Purpose:    Change a single pixel in RGB color space to its floating-point 
@@ -102,55 +61,6 @@ struct YPbPr_pixel pixelToYPbPr(Pnm_rgb pixel, unsigned denominator)
         return newPixel;
 }
 
-/*
- * Name:       convertYbPbPrApply
- * Purpose:    Transform each pixel from RGB color space into component video 
- *             color space
- * Parameters: int col: an integer representing the distance between the
- *             current element and the left edge of the array
- *             int row: an integer representing the distance between the
- *             current element and the top of the array
- *             A2Methods_UArray2 array2: required by the A2Methods_Object
- *             interface; ignored here
- *             A2Methods_Object *elem: a pointer to a YPbPr_pixel representing 
- *             the current pixel of the image transformed into component video 
- *             color space
- *             void *cl: a pointer to a Closure struct containing a pointer
- *             to a A2Methods_UArray2 (the destination image in YPbPr_pixel
- *             format), a pointer to an A2Methods_T struct with function
- *             pointers for operating on the array, and an unsigned integer 
- *             representing the maximum color value of the PPM
- * Return:     None
- * Expects:    elem to not be NULL and cl points to a Closure struct that
- *             stores a non-NULL A2Methods_UArray2 and A2Methods_T struct 
- *             and is not NULL
- *             col and row are within the bounds of the array
- * Notes:      will CRE if cl is NULL or its array or methods field is NULL
- *             will CRE if elem is NULL
- *             If col or row are out of bounds or not used by the array,
- *             the methods->at function will throw a CRE
- */
-void convertYbPbPrApply(int col, int row, A2Methods_UArray2 array2,
-                        A2Methods_Object *elem, void *cl)
-{
-        assert(elem != NULL && cl != NULL);
-
-        struct Closure *closure = cl;
-        assert(closure->array != NULL && closure != NULL &&
-               closure->methods != NULL);
-
-        A2Methods_UArray2 original = closure->array;
-
-        Pnm_rgb currPixel = closure->methods->at(original, col, row);
-        assert(currPixel != NULL);
-
-        struct YPbPr_pixel *newPixel = elem;
-
-        *newPixel = pixelToYPbPr(currPixel, closure->denominator);
-
-        (void) array2;
-}
-
 /************************ YPbPrToRGB ******************************
  *
  * Converts each pixel of an image from component video color space into RGB 
@@ -163,6 +73,8 @@ void convertYbPbPrApply(int col, int row, A2Methods_UArray2 array2,
  *        color space
  *        const struct A2Methods_T *methods: A pointer to a A2Methods_T struct
  *        that contains pointers to functions on can use on a UArray2
+ *        int threads: the number of threads to run the stage on,
+ *        counting the calling thread
  *        unsigned denominator: an unsigned integer representing the
  *        maximum color value of the PPM
  *
@@ -182,7 +94,7 @@ void convertYbPbPrApply(int col, int row, A2Methods_UArray2 array2,
  *
  ************************************************************/
 A2Methods_UArray2 YPbPrToRGB(A2Methods_UArray2 original, unsigned denominator,
-                             const struct A2Methods_T *methods)
+                             const struct A2Methods_T *methods, int threads)
 {
         assert(original != NULL && methods != NULL);
 
@@ -194,7 +106,8 @@ A2Methods_UArray2 YPbPrToRGB(A2Methods_UArray2 original, unsigned denominator,
                               .methods = methods,
                               .denominator = denominator };
 
-        methods->map_default(destination, convertRgbApply, &cl);
+        A2Extended(methods)->map_spans_parallel(destination, threads,
+                                                convertRgbSpan, &cl);
 
         return destination;
 }
@@ -239,51 +152,61 @@ struct Pnm_rgb pixelToRGB(struct YPbPr_pixel *pixel, unsigned denominator)
 }
 
 /*
- * Name:       convertRgbApply
+ * Name:       convertRgbSpan
  * Purpose:    Transform each pixel from component video color space into RGB 
  *             color space
- * Parameters: int col: an integer representing the distance between the
- *             current element and the left edge of the array
- *             int row: an integer representing the distance between the
- *             current element and the top of the array
- *             A2Methods_UArray2 array2: required by the A2Methods_Object
- *             interface; ignored here
- *             void *elem: a pointer to a Pnm_rgb struct representing the
- *             current pixel of the image transformed into RGB color space
+ * Parameters: int col: the column of the first element of the span
+ *             int row: the row of the span
+ *             int count: the number of elements in the span
+ *             A2Methods_Object *base: a pointer to the first Pnm_rgb struct
+ *             of the span, representing pixels of the image transformed into
+ *             RGB color space
+ *             int stride: the number of bytes from one element of
+ *             the span to the next
  *             void *cl: a pointer to a Closure struct containing a pointer
  *             to a A2Methods_UArray2 (the destination image in YPbPr_pixel
  *             format), a pointer to an A2Methods_T struct with function
  *             pointers for operating on the array, and an unsigned integer 
  *             representing the maximum color value of the PPM
  * Return:     None
- * Expects:    elem to not be NULL and cl points to a Closure struct that
+ * Expects:    base to not be NULL and cl points to a Closure struct that
  *             stores a non-NULL A2Methods_UArray2 and A2Methods_T struct 
  *             and is not NULL
- *             col and row are within the bounds of the array
+ *             the span is within the bounds of the array
  * Notes:      will CRE if cl is NULL or its array or methods field is NULL
- *             will CRE if elem is NULL
- *             If col or row are out of bounds or not used by the array,
- *             the methods->at function will throw a CRE
+ *             will CRE if base is NULL
+ *             If the span is out of bounds, A2Span_new will throw
+ *             a CRE
+ *             When both spans are stored as arrays, the whole span is
+ *             converted at once by YPbPrRowToRGB()
  */
-void convertRgbApply(int col, int row, A2Methods_UArray2 array2, void *elem,
-                     void *cl)
+void convertRgbSpan(int col, int row, int count, A2Methods_Object *base,
+                    int stride, void *cl)
 {
-        assert(elem != NULL && cl != NULL);
+        assert(base != NULL && cl != NULL);
 
         struct Closure *closure = cl;
         assert(closure->array != NULL && closure != NULL &&
                closure->methods != NULL);
 
-        A2Methods_UArray2 original = closure->array;
-
-        struct YPbPr_pixel *oldPixel = closure->methods->at(original, col, row);
-        assert(oldPixel != NULL);
-
-        Pnm_rgb newPixel = elem;
+        struct A2Span original = A2Span_new(closure->methods, closure->array,
+                                            col, row, count);
+        if (original.base != NULL &&
+            original.stride == sizeof(struct YPbPr_pixel) &&
+            stride == sizeof(struct Pnm_rgb)) {
+                YPbPrRowToRGB((const struct YPbPr_pixel *) original.base,
+                              (struct Pnm_rgb *) base, count,
+                              closure->denominator);
+                return;
+        }
 
-        *newPixel = pixelToRGB(oldPixel, closure->denominator);
+        char *newPixels = base;
+        for (int i = 0; i < count; i++) {
+                struct YPbPr_pixel *oldPixel = A2Span_at(&original, i);
+                Pnm_rgb newPixel = (Pnm_rgb) (newPixels + (long) i * stride);
 
-        (void) array2;
+                *newPixel = pixelToRGB(oldPixel, closure->denominator);
+        }
 }
 
 /*
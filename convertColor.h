@@ -20,16 +20,12 @@
 #include "pnm.h"
 #include "helpers.h"
 
-A2Methods_UArray2 rgbToYPbPr(A2Methods_UArray2 original, unsigned denominator,
-                             const struct A2Methods_T *methods);
 struct YPbPr_pixel pixelToYPbPr(Pnm_rgb pixel, unsigned denominator);
-void convertYbPbPrApply(int col, int row, A2Methods_UArray2 array2,
-                        A2Methods_Object *elem, void *cl);
 
 A2Methods_UArray2 YPbPrToRGB(A2Methods_UArray2 original, unsigned denominator,
-                             const struct A2Methods_T *methods);
+                             const struct A2Methods_T *methods, int threads);
 struct Pnm_rgb pixelToRGB(struct YPbPr_pixel *pixel, unsigned denominator);
-void convertRgbApply(int col, int row, A2Methods_UArray2 array2, void *elem,
-                     void *cl);
+void convertRgbSpan(int col, int row, int count, A2Methods_Object *base,
+                    int stride, void *cl);
 
 #endif
@@ -0,0 +1,188 @@
+/**************************************************************
+ *                     crc32c.c
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the implementation of crc32cWords(). On x86-64
+ *     processors with SSE4.2 the checksum is computed 8 bytes at a time
+ *     with the crc32 instruction; everywhere else it uses slicing-by-8
+ *     tables, which also handle 8 bytes per step. Which one to use is
+ *     decided once, the first time a checksum is computed.
+ *
+ **************************************************************/
+#include "crc32c.h"
+#include <pthread.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define HAVE_CRC32_INSTRUCTION 1
+#include <nmmintrin.h>
+#endif
+
+/* the CRC32C polynomial, bit-reversed */
+static const uint32_t POLYNOMIAL = 0x82F63B78;
+
+typedef uint32_t Crc_wordsfun(uint32_t crc, const uint32_t *words,
+                              size_t count);
+
+static uint32_t table[8][256];
+static Crc_wordsfun *updateWords;
+static pthread_once_t setupOnce = PTHREAD_ONCE_INIT;
+
+static void setup(void);
+static uint32_t tableWords(uint32_t crc, const uint32_t *words,
+                           size_t count);
+static inline uint32_t tableStep(uint32_t crc, uint32_t low, uint32_t high);
+static inline uint32_t swapWord(uint32_t word);
+
+/*
+ * Name:       crc32cWords
+ * Purpose:    Computes the CRC32C checksum of an array of 32-bit code
+ *             words as they are stored: each in big-endian order
+ * Parameters: uint32_t crc: the checksum of the bytes before these, or 0
+ *             const uint32_t *words: the words to check, in host order
+ *             size_t count: the number of words
+ * Return:     the checksum of the earlier bytes followed by these words
+ * Expects:    words to not be NULL unless count is 0
+ * Notes:      safe to call from several threads at once
+ *             Checks the bytes that printWords() would print for words,
+ *             without swapping them into a buffer first.
+ */
+uint32_t crc32cWords(uint32_t crc, const uint32_t *words, size_t count)
+{
+        pthread_once(&setupOnce, setup);
+        return ~updateWords(~crc, words, count);
+}
+
+#ifdef HAVE_CRC32_INSTRUCTION
+/*
+ * Name:       instructionWords
+ * Purpose:    a private function that runs the crc32 instruction over the
+ *             big-endian bytes of an array of words
+ * Parameters: uint32_t crc: the running (inverted) checksum
+ *             const uint32_t *words: the words to check, in host order
+ *             size_t count: the number of words
+ * Return:     the running checksum after the words
+ * Expects:    the processor to support SSE4.2
+ * Notes:      two swapped words make up the 8 bytes of each crc32
+ */
+__attribute__((target("sse4.2"))) static uint32_t
+instructionWords(uint32_t crc, const uint32_t *words, size_t count)
+{
+        uint64_t crc64 = crc;
+        for (; count >= 2; count -= 2, words += 2) {
+                uint64_t chunk = (uint64_t) swapWord(words[1]) << 32 |
+                                 swapWord(words[0]);
+                crc64 = _mm_crc32_u64(crc64, chunk);
+        }
+
+        crc = crc64;
+        if (count > 0) {
+                crc = _mm_crc32_u32(crc, swapWord(words[0]));
+        }
+        return crc;
+}
+#endif
+
+/*
+ * Name:       setup
+ * Purpose:    a private function that builds the slicing-by-8 tables and
+ *             picks the fastest way to compute checksums on this processor
+ * Parameters: None
+ * Return:     None
+ * Expects:    to be run once, through pthread_once()
+ * Notes:      table[k][i] is the checksum of byte i followed by k zero
+ *             bytes
+ */
+static void setup(void)
+{
+        for (unsigned i = 0; i < 256; i++) {
+                uint32_t crc = i;
+                for (int bit = 0; bit < 8; bit++) {
+                        crc = crc & 1 ? crc >> 1 ^ POLYNOMIAL : crc >> 1;
+                }
+                table[0][i] = crc;
+        }
+        for (unsigned i = 0; i < 256; i++) {
+                for (int k = 1; k < 8; k++) {
+                        uint32_t previous = table[k - 1][i];
+                        table[k][i] = previous >> 8 ^
+                                      table[0][previous & 0xff];
+                }
+        }
+
+        updateWords = tableWords;
+#ifdef HAVE_CRC32_INSTRUCTION
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("sse4.2")) {
+                updateWords = instructionWords;
+        }
+#endif
+}
+
+/*
+ * Name:       tableWords
+ * Purpose:    a private function that checks the big-endian bytes of an
+ *             array of words with the slicing-by-8 tables
+ * Parameters: uint32_t crc: the running (inverted) checksum
+ *             const uint32_t *words: the words to check, in host order
+ *             size_t count: the number of words
+ * Return:     the running checksum after the words
+ * Expects:    the tables to be built
+ * Notes:      None
+ */
+static uint32_t tableWords(uint32_t crc, const uint32_t *words,
+                           size_t count)
+{
+        for (; count >= 2; count -= 2, words += 2) {
+                crc = tableStep(crc, swapWord(words[0]), swapWord(words[1]));
+        }
+
+        if (count > 0) {
+                uint32_t word = words[0];
+                for (int shift = 24; shift >= 0; shift -= 8) {
+                        crc = table[0][(crc ^ word >> shift) & 0xff] ^
+                              crc >> 8;
+                }
+        }
+        return crc;
+}
+
+/*
+ * Name:       tableStep
+ * Purpose:    a private function that checks 8 bytes with the slicing-by-8
+ *             tables
+ * Parameters: uint32_t crc: the running (inverted) checksum
+ *             uint32_t low: the first 4 bytes, the first in the low byte
+ *             uint32_t high: the last 4 bytes, the first in the low byte
+ * Return:     the running checksum after the 8 bytes
+ * Expects:    the tables to be built
+ * Notes:      None
+ */
+static inline uint32_t tableStep(uint32_t crc, uint32_t low, uint32_t high)
+{
+        low ^= crc;
+        return table[7][low & 0xff] ^ table[6][low >> 8 & 0xff] ^
+               table[5][low >> 16 & 0xff] ^ table[4][low >> 24] ^
+               table[3][high & 0xff] ^ table[2][high >> 8 & 0xff] ^
+               table[1][high >> 16 & 0xff] ^ table[0][high >> 24];
+}
+
+/*
+ * Name:       swapWord
+ * Purpose:    a private function that gets a word whose bytes, from the
+ *             low byte up, are the bytes of word in big-endian order
+ * Parameters: uint32_t word: the word to swap
+ * Return:     the swapped word
+ * Expects:    None
+ * Notes:      the compiler turns this into a bswap instruction
+ */
+static inline uint32_t swapWord(uint32_t word)
+{
+        return word >> 24 | (word >> 8 & 0xff00) | (word << 8 & 0xff0000) |
+               word << 24;
+}
@@ -0,0 +1,25 @@
+/**************************************************************
+ *                     crc32c.h
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the function declarations for crc32c.c, which
+ *     computes CRC32C (Castagnoli) checksums. A checksum can be built up
+ *     over several calls by passing the result of one call as the crc of
+ *     the next, starting from 0.
+ *
+ **************************************************************/
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+uint32_t crc32cWords(uint32_t crc, const uint32_t *words, size_t count);
+
+#endif
@@ -0,0 +1,684 @@
+/**************************************************************
+ *                     fixedPoint.c
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the implementations for the fixed-point engine.
+ *     Y, Pb, and Pr are 32-bit integers with FRACTION_BITS fraction bits,
+ *     so 1.0 is ONE. Adding the four values of a block gives 4 times their
+ *     mean, which is the same as the mean with 2 more fraction bits, so
+ *     the 2x2 transform and the chroma averages are only adds. The
+ *     dequantized values and the chroma index boundaries are found once,
+ *     from the same functions the float engine uses, so the two engines
+ *     only differ where a value rounds differently.
+ *
+ *     This is an exactness mode, not a fast one. The float engine converts
+ *     colors with SIMD and is faster; the point of this engine is that
+ *     integer arithmetic gives the same bytes on every host and with every
+ *     compiler and set of floating-point flags.
+ *
+ *     Every product fits in 32 bits: the color coefficients have
+ *     COEFFICIENT_BITS fraction bits on top of FRACTION_BITS and add up to
+ *     at most 1, and the values they multiply are at most the maximum
+ *     color value or ONE / 2.
+ *
+ **************************************************************/
+#include "fixedPoint.h"
+#include "codeword.h"
+#include "convertColor.h"
+#include "quantize.h"
+#include "packWord.h"
+#include "arith40.h"
+#include "assert.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+/* fraction bits of a fixed-point Y, Pb, or Pr, and its 1.0 */
+static const int FRACTION_BITS = 16;
+static const int32_t ONE = 1 << 16;
+/* fraction bits of the sum of the four values of a block, and its 1.0 */
+static const int SUM_BITS = 18;
+static const int32_t SUM_ONE = 1 << 18;
+/* extra fraction bits of the color conversion coefficients */
+static const int COEFFICIENT_BITS = 14;
+
+/* linearQuantizeValue()'s scale for a, (9^2 - 1) / 1 */
+static const int32_t A_SCALE = 80;
+/* linearQuantizeValue()'s scale for b, c, and d, (4^2 - 1) / 0.3 */
+static const int32_t BCD_SCALE = 50;
+/* the largest quantized b, c, or d, 0.3 * BCD_SCALE */
+static const int32_t BCD_LIMIT = 15;
+/* the number of values a 9-bit a and a 5-bit b, c, or d can hold */
+static const unsigned A_VALUES = 512;
+static const unsigned BCD_VALUES = 32;
+/* the number of quantized chroma values */
+static const unsigned CHROMA_VALUES = 16;
+
+/*
+ * Name:       Mismatch
+ * Purpose:    Counts how much the fixed-point engine differed from the
+ *             float engine
+ * Components:
+ *             size_t words, wordsDiffer: the code words checked, and how
+ *             many of them differed
+ *             unsigned fields[6]: the largest difference seen in each
+ *             field of a code word: a, b, c, d, avgPb, and avgPr
+ *             size_t bytes, bytesDiffer: the pixel bytes checked, and how
+ *             many of them differed
+ *             unsigned byte: the largest difference seen in a byte
+ */
+struct Mismatch {
+        size_t words, wordsDiffer;
+        unsigned fields[6];
+        size_t bytes, bytesDiffer;
+        unsigned byte;
+};
+
+static int32_t aValue[512];
+static int32_t bcdValue[32];
+static int32_t chromaValue[16];
+static int32_t chromaLimit[15];
+static pthread_once_t setupOnce = PTHREAD_ONCE_INIT;
+
+static struct Mismatch report;
+static pthread_mutex_t reportLock = PTHREAD_MUTEX_INITIALIZER;
+
+static void setup(void);
+static void startCoefficients(unsigned denominator, int32_t k[9]);
+static void toFixedYPbPr(const int32_t k[9], const struct Pnm_rgb *pixel,
+                         int32_t *Y, int32_t *Pb, int32_t *Pr);
+static uint32_t fixedBlockToWord(const int32_t Y[4], int32_t sumPb,
+                                 int32_t sumPr);
+static int quantizeBCD(int32_t sum);
+static unsigned chromaIndex(int32_t sum);
+static void fixedWordToYPbPr(uint32_t word, int32_t Y[4], int32_t *Pb,
+                             int32_t *Pr);
+static void fixedToBytes(int32_t Y, int32_t Pb, int32_t Pr,
+                         unsigned char *pixel);
+static unsigned char scaleByte(int32_t value);
+static int32_t clampFixed(int32_t value, int32_t min, int32_t max);
+static unsigned difference(int first, int second);
+static void addMismatch(const struct Mismatch *found);
+
+/*
+ * Name:       fixedRowsToWords
+ * Purpose:    Compresses a row of 2x2 blocks, given the two rows of pixels
+ *             they cover, into their code words in fixed point
+ * Parameters: const struct Pnm_rgb *top: the top row of pixels
+ *             const struct Pnm_rgb *bottom: the bottom row of pixels
+ *             unsigned count: the number of blocks, half the pixels in a row
+ *             unsigned denominator: the maximum color value of the PPM
+ *             uint32_t *words: where the count code words are stored
+ * Return:     None
+ * Expects:    top, bottom, and words to not be NULL
+ *             the color values to be at most denominator, which is at
+ *             most 65535
+ * Notes:      will CRE if top, bottom, or words is NULL
+ *             safe to call from several threads at once
+ */
+void fixedRowsToWords(const struct Pnm_rgb *top, const struct Pnm_rgb *bottom,
+                      unsigned count, unsigned denominator, uint32_t *words)
+{
+        assert(top != NULL && bottom != NULL && words != NULL);
+        pthread_once(&setupOnce, setup);
+        int32_t k[9];
+        startCoefficients(denominator, k);
+
+        for (unsigned i = 0; i < count; i++) {
+                const struct Pnm_rgb *pixels[4] = {
+                        &top[2 * i], &top[2 * i + 1], &bottom[2 * i],
+                        &bottom[2 * i + 1]
+                };
+                int32_t Y[4], sumPb = 0, sumPr = 0;
+                for (int j = 0; j < 4; j++) {
+                        int32_t Pb, Pr;
+                        toFixedYPbPr(k, pixels[j], &Y[j], &Pb, &Pr);
+                        sumPb += Pb;
+                        sumPr += Pr;
+                }
+                words[i] = fixedBlockToWord(Y, sumPb, sumPr);
+        }
+}
+
+/*
+ * Name:       fixedWordsToBytes
+ * Purpose:    Decompresses a row of code words in fixed point into the
+ *             bytes a raw PPM with a maximum color value of 255 stores for
+ *             the two rows of pixels they cover
+ * Parameters: const uint32_t *words: the code words to decompress
+ *             unsigned count: the number of code words
+ *             unsigned char *top: where the 6 * count bytes of the top row
+ *             are stored
+ *             unsigned char *bottom: where the 6 * count bytes of the
+ *             bottom row are stored
+ * Return:     None
+ * Expects:    words, top, and bottom to not be NULL
+ * Notes:      will CRE if words, top, or bottom is NULL
+ *             safe to call from several threads at once
+ */
+void fixedWordsToBytes(const uint32_t *words, unsigned count,
+                       unsigned char *top, unsigned char *bottom)
+{
+        assert(words != NULL && top != NULL && bottom != NULL);
+        pthread_once(&setupOnce, setup);
+
+        for (unsigned i = 0; i < count; i++) {
+                int32_t Y[4], Pb, Pr;
+                fixedWordToYPbPr(words[i], Y, &Pb, &Pr);
+                fixedToBytes(Y[0], Pb, Pr, top + 6 * i);
+                fixedToBytes(Y[1], Pb, Pr, top + 6 * i + 3);
+                fixedToBytes(Y[2], Pb, Pr, bottom + 6 * i);
+                fixedToBytes(Y[3], Pb, Pr, bottom + 6 * i + 3);
+        }
+}
+
+/*
+ * Name:       fixedWordsToPreviewBytes
+ * Purpose:    Decompresses a row of code words in fixed point into a row
+ *             of a half-resolution preview: one pixel per code word, the
+ *             mean color of its 2x2 block
+ * Parameters: const uint32_t *words: the code words to decompress
+ *             unsigned count: the number of code words
+ *             unsigned char *pixels: where the 3 * count bytes are stored,
+ *             as a raw PPM with a maximum color value of 255 stores them
+ * Return:     None
+ * Expects:    words and pixels to not be NULL
+ * Notes:      will CRE if words or pixels is NULL
+ *             safe to call from several threads at once
+ */
+void fixedWordsToPreviewBytes(const uint32_t *words, unsigned count,
+                              unsigned char *pixels)
+{
+        assert(words != NULL && pixels != NULL);
+        pthread_once(&setupOnce, setup);
+
+        for (unsigned i = 0; i < count; i++) {
+                unsigned a, avgPb, avgPr;
+                unbitpackMean(words[i], &a, &avgPb, &avgPr);
+                fixedToBytes(aValue[a], chromaValue[avgPb],
+                             chromaValue[avgPr], pixels + 3 * i);
+        }
+}
+
+/*
+ * Name:       checkFixedWords
+ * Purpose:    Compares a row of code words from fixedRowsToWords() with
+ *             the ones the float engine gives for the same pixels, and adds
+ *             the differences to the report
+ * Parameters: const struct Pnm_rgb *top: the top row of pixels
+ *             const struct Pnm_rgb *bottom: the bottom row of pixels
+ *             unsigned count: the number of blocks
+ *             unsigned denominator: the maximum color value of the PPM
+ *             const uint32_t *words: the fixed-point code words
+ * Return:     None
+ * Expects:    top, bottom, and words to not be NULL
+ * Notes:      will CRE if top, bottom, or words is NULL
+ *             safe to call from several threads at once
+ */
+void checkFixedWords(const struct Pnm_rgb *top, const struct Pnm_rgb *bottom,
+                     unsigned count, unsigned denominator,
+                     const uint32_t *words)
+{
+        assert(top != NULL && bottom != NULL && words != NULL);
+        struct Mismatch found = { .words = count };
+
+        for (unsigned i = 0; i < count; i++) {
+                uint32_t reference = rgbToWord(
+                        (Pnm_rgb) &top[2 * i], (Pnm_rgb) &top[2 * i + 1],
+                        (Pnm_rgb) &bottom[2 * i],
+                        (Pnm_rgb) &bottom[2 * i + 1], denominator);
+                if (reference == words[i]) {
+                        continue;
+                }
+
+                struct Quantized_Block fields[2];
+                uint32_t pair[2] = { reference, words[i] };
+                for (int j = 0; j < 2; j++) {
+                        unbitpackWord(pair[j], &fields[j].a, &fields[j].b,
+                                      &fields[j].c, &fields[j].d,
+                                      &fields[j].avgPb, &fields[j].avgPr);
+                }
+                unsigned differences[6] = {
+                        difference(fields[0].a, fields[1].a),
+                        difference(fields[0].b, fields[1].b),
+                        difference(fields[0].c, fields[1].c),
+                        difference(fields[0].d, fields[1].d),
+                        difference(fields[0].avgPb, fields[1].avgPb),
+                        difference(fields[0].avgPr, fields[1].avgPr)
+                };
+
+                found.wordsDiffer++;
+                for (int j = 0; j < 6; j++) {
+                        if (differences[j] > found.fields[j]) {
+                                found.fields[j] = differences[j];
+                        }
+                }
+        }
+
+        addMismatch(&found);
+}
+
+/*
+ * Name:       checkFixedBytes
+ * Purpose:    Compares the bytes fixedWordsToBytes() gave for a row of
+ *             code words with the ones the float engine gives, and adds
+ *             the differences to the report
+ * Parameters: const uint32_t *words: the code words
+ *             unsigned count: the number of code words
+ *             const unsigned char *top: the fixed-point bytes of the top
+ *             row of pixels
+ *             const unsigned char *bottom: the fixed-point bytes of the
+ *             bottom row of pixels
+ * Return:     None
+ * Expects:    words, top, and bottom to not be NULL
+ * Notes:      will CRE if words, top, or bottom is NULL
+ *             safe to call from several threads at once
+ */
+void checkFixedBytes(const uint32_t *words, unsigned count,
+                     const unsigned char *top, const unsigned char *bottom)
+{
+        assert(words != NULL && top != NULL && bottom != NULL);
+        struct Mismatch found = { .bytes = 12 * (size_t) count };
+
+        for (unsigned i = 0; i < count; i++) {
+                struct Pnm_rgb pixels[4];
+                wordToRGB(words[i], 255, &pixels[0], &pixels[1], &pixels[2],
+                          &pixels[3]);
+
+                const unsigned char *fixed[4] = {
+                        top + 6 * i, top + 6 * i + 3, bottom + 6 * i,
+                        bottom + 6 * i + 3
+                };
+                for (int j = 0; j < 4; j++) {
+                        unsigned reference[3] = { pixels[j].red,
+                                                  pixels[j].green,
+                                                  pixels[j].blue };
+                        for (int color = 0; color < 3; color++) {
+                                unsigned apart = difference(reference[color],
+                                                          fixed[j][color]);
+                                found.bytesDiffer += apart != 0;
+                                if (apart > found.byte) {
+                                        found.byte = apart;
+                                }
+                        }
+                }
+        }
+
+        addMismatch(&found);
+}
+
+/*
+ * Name:       checkFixedPreview
+ * Purpose:    Compares the bytes fixedWordsToPreviewBytes() gave for a row
+ *             of code words with the ones the float engine gives, and adds
+ *             the differences to the report
+ * Parameters: const uint32_t *words: the code words
+ *             unsigned count: the number of code words
+ *             const unsigned char *pixels: the fixed-point bytes
+ * Return:     None
+ * Expects:    words and pixels to not be NULL
+ * Notes:      will CRE if words or pixels is NULL
+ *             safe to call from several threads at once
+ */
+void checkFixedPreview(const uint32_t *words, unsigned count,
+                       const unsigned char *pixels)
+{
+        assert(words != NULL && pixels != NULL);
+        struct Mismatch found = { .bytes = 3 * (size_t) count };
+
+        for (unsigned i = 0; i < count; i++) {
+                unsigned a, avgPb, avgPr;
+                unbitpackMean(words[i], &a, &avgPb, &avgPr);
+                struct YPbPr_pixel mean;
+                dequantizeMean(a, avgPb, avgPr, &mean);
+                struct Pnm_rgb rgb = pixelToRGB(&mean, 255);
+
+                unsigned reference[3] = { rgb.red, rgb.green, rgb.blue };
+                for (int color = 0; color < 3; color++) {
+                        unsigned apart = difference(reference[color],
+                                                  pixels[3 * i + color]);
+                        found.bytesDiffer += apart != 0;
+                        if (apart > found.byte) {
+                                found.byte = apart;
+                        }
+                }
+        }
+
+        addMismatch(&found);
+}
+
+/*
+ * Name:       printFixedReport
+ * Purpose:    Prints how much the fixed-point engine has differed from the
+ *             float engine in everything the check functions compared
+ * Parameters: FILE *output: where the report is printed
+ * Return:     None
+ * Expects:    output to not be NULL
+ * Notes:      will CRE if output is NULL
+ *             prints one line for code words and one for bytes, for each
+ *             that was checked
+ */
+void printFixedReport(FILE *output)
+{
+        assert(output != NULL);
+        pthread_mutex_lock(&reportLock);
+        if (report.words > 0) {
+                fprintf(output,
+                        "fixed point: %zu of %zu code words differ from "
+                        "float; largest field differences: a %u, b %u, "
+                        "c %u, d %u, avgPb %u, avgPr %u\n",
+                        report.wordsDiffer, report.words, report.fields[0],
+                        report.fields[1], report.fields[2], report.fields[3],
+                        report.fields[4], report.fields[5]);
+        }
+        if (report.bytes > 0) {
+                fprintf(output,
+                        "fixed point: %zu of %zu bytes differ from float, "
+                        "by at most %u\n",
+                        report.bytesDiffer, report.bytes, report.byte);
+        }
+        pthread_mutex_unlock(&reportLock);
+}
+
+/*
+ * Name:       setup
+ * Purpose:    a private function that finds the fixed-point values of
+ *             every quantized field and where the chroma indexes change
+ * Parameters: None
+ * Return:     None
+ * Expects:    to be run once, through pthread_once()
+ * Notes:      chromaLimit[k] is the smallest sum of four Pb or Pr values
+ *             whose mean Arith40_index_of_chroma() puts above index k,
+ *             found by binary search since the index only grows with the
+ *             mean
+ */
+static void setup(void)
+{
+        for (unsigned a = 0; a < A_VALUES; a++) {
+                aValue[a] = lround(linearDequantizeValue(a, 9, 1) * ONE);
+        }
+        for (unsigned i = 0; i < BCD_VALUES; i++) {
+                int value = (int) i - (int) BCD_VALUES / 2;
+                bcdValue[i] = lround(linearDequantizeValue(value, 4, 0.3) *
+                                     ONE);
+        }
+        for (unsigned i = 0; i < CHROMA_VALUES; i++) {
+                chromaValue[i] = lround(Arith40_chroma_of_index(i) * ONE);
+        }
+
+        for (unsigned k = 0; k + 1 < CHROMA_VALUES; k++) {
+                int32_t low = -SUM_ONE / 2;
+                int32_t high = SUM_ONE / 2 + 1;
+                while (high - low > 1) {
+                        int32_t middle = low + (high - low) / 2;
+                        float mean = (float) middle / SUM_ONE;
+                        if (Arith40_index_of_chroma(mean) > k) {
+                                high = middle;
+                        } else {
+                                low = middle;
+                        }
+                }
+                chromaLimit[k] = high;
+        }
+}
+
+/*
+ * Name:       startCoefficients
+ * Purpose:    a private function that finds the color conversion
+ *             coefficients for an image's maximum color value
+ * Parameters: unsigned denominator: the maximum color value
+ *             int32_t k[9]: where the coefficients are stored: the red,
+ *             green, and blue coefficients of Y, then of Pb, then of Pr
+ * Return:     None
+ * Expects:    denominator to be from 1 to 65535
+ * Notes:      each coefficient is divided by denominator here, so
+ *             converting a pixel needs no divides
+ */
+static void startCoefficients(unsigned denominator, int32_t k[9])
+{
+        static const double coefficients[9] = {
+                0.299, 0.587, 0.114,
+                -0.168736, -0.331264, 0.5,
+                0.5, -0.418688, -0.081312
+        };
+        assert(denominator > 0);
+        double scale = (double) (ONE << COEFFICIENT_BITS) / denominator;
+        for (int i = 0; i < 9; i++) {
+                k[i] = lround(coefficients[i] * scale);
+        }
+}
+
+/*
+ * Name:       toFixedYPbPr
+ * Purpose:    a private function that converts one pixel to fixed-point
+ *             component video color space
+ * Parameters: const int32_t k[9]: the coefficients from startCoefficients()
+ *             const struct Pnm_rgb *pixel: the pixel to convert
+ *             int32_t *Y, *Pb, *Pr: where the values are stored
+ * Return:     None
+ * Expects:    the color values to be at most the maximum color value the
+ *             coefficients are for
+ * Notes:      rounds to nearest, and clamps like pixelToYPbPr()
+ */
+static void toFixedYPbPr(const int32_t k[9], const struct Pnm_rgb *pixel,
+                         int32_t *Y, int32_t *Pb, int32_t *Pr)
+{
+        int32_t r = pixel->red;
+        int32_t g = pixel->green;
+        int32_t b = pixel->blue;
+        int32_t half = 1 << (COEFFICIENT_BITS - 1);
+
+        *Y = clampFixed((k[0] * r + k[1] * g + k[2] * b + half) >>
+                                COEFFICIENT_BITS,
+                        0, ONE);
+        *Pb = clampFixed((k[3] * r + k[4] * g + k[5] * b + half) >>
+                                 COEFFICIENT_BITS,
+                         -ONE / 2, ONE / 2);
+        *Pr = clampFixed((k[6] * r + k[7] * g + k[8] * b + half) >>
+                                 COEFFICIENT_BITS,
+                         -ONE / 2, ONE / 2);
+}
+
+/*
+ * Name:       fixedBlockToWord
+ * Purpose:    a private function that transforms, quantizes, and packs
+ *             one block of fixed-point pixels into its code word
+ * Parameters: const int32_t Y[4]: the Y of the top left, top right,
+ *             bottom left, and bottom right pixels
+ *             int32_t sumPb, sumPr: the sums of the block's Pb and Pr
+ * Return:     the code word
+ * Expects:    the values to be clamped like toFixedYPbPr() clamps them
+ * Notes:      each sum is 4 times the value pixelToDCT() or
+ *             averageChroma() finds, so it has SUM_BITS fraction bits
+ */
+static uint32_t fixedBlockToWord(const int32_t Y[4], int32_t sumPb,
+                                 int32_t sumPr)
+{
+        int32_t a = Y[3] + Y[2] + Y[1] + Y[0];
+        int32_t b = Y[3] + Y[2] - Y[1] - Y[0];
+        int32_t c = Y[3] - Y[2] + Y[1] - Y[0];
+        int32_t d = Y[3] - Y[2] - Y[1] + Y[0];
+
+        unsigned quantizedA = (a * A_SCALE + SUM_ONE / 2) >> SUM_BITS;
+        return bitpackWord(quantizedA, quantizeBCD(b), quantizeBCD(c),
+                           quantizeBCD(d), chromaIndex(sumPb),
+                           chromaIndex(sumPr));
+}
+
+/*
+ * Name:       quantizeBCD
+ * Purpose:    a private function that quantizes b, c, or d like
+ *             quantizeBlock() does
+ * Parameters: int32_t sum: the coefficient, with SUM_BITS fraction bits
+ * Return:     the coefficient clamped to +-0.3 and scaled to +-BCD_LIMIT
+ * Expects:    None
+ * Notes:      rounds halves away from zero, like round()
+ */
+static int quantizeBCD(int32_t sum)
+{
+        int32_t scaled = clampFixed(sum * BCD_SCALE, -BCD_LIMIT * SUM_ONE,
+                                    BCD_LIMIT * SUM_ONE);
+        if (scaled < 0) {
+                return -((-scaled + SUM_ONE / 2) >> SUM_BITS);
+        }
+        return (scaled + SUM_ONE / 2) >> SUM_BITS;
+}
+
+/*
+ * Name:       chromaIndex
+ * Purpose:    a private function that quantizes a chroma average like
+ *             Arith40_index_of_chroma() does
+ * Parameters: int32_t sum: the sum of the block's four Pb or Pr values
+ * Return:     the chroma index
+ * Expects:    setup() to have run
+ * Notes:      None
+ */
+static unsigned chromaIndex(int32_t sum)
+{
+        unsigned index = 0;
+        while (index + 1 < CHROMA_VALUES && sum >= chromaLimit[index]) {
+                index++;
+        }
+        return index;
+}
+
+/*
+ * Name:       fixedWordToYPbPr
+ * Purpose:    a private function that unpacks and dequantizes one code
+ *             word into the fixed-point pixels of its block
+ * Parameters: uint32_t word: the code word
+ *             int32_t Y[4]: where the Y of the top left, top right, bottom
+ *             left, and bottom right pixels are stored
+ *             int32_t *Pb, *Pr: where the block's chroma is stored
+ * Return:     None
+ * Expects:    setup() to have run
+ * Notes:      the inverse transform is DCTtoPixel()'s
+ */
+static void fixedWordToYPbPr(uint32_t word, int32_t Y[4], int32_t *Pb,
+                             int32_t *Pr)
+{
+        struct Quantized_Block quantized;
+        unbitpackWord(word, &quantized.a, &quantized.b, &quantized.c,
+                      &quantized.d, &quantized.avgPb, &quantized.avgPr);
+
+        int32_t a = aValue[quantized.a];
+        int32_t b = bcdValue[quantized.b + BCD_VALUES / 2];
+        int32_t c = bcdValue[quantized.c + BCD_VALUES / 2];
+        int32_t d = bcdValue[quantized.d + BCD_VALUES / 2];
+
+        Y[0] = a - b - c + d;
+        Y[1] = a - b + c - d;
+        Y[2] = a + b - c - d;
+        Y[3] = a + b + c + d;
+        *Pb = chromaValue[quantized.avgPb];
+        *Pr = chromaValue[quantized.avgPr];
+}
+
+/*
+ * Name:       fixedToBytes
+ * Purpose:    a private function that converts one fixed-point pixel to
+ *             the 3 bytes a raw PPM with a maximum color value of 255
+ *             stores for it
+ * Parameters: int32_t Y, Pb, Pr: the pixel
+ *             unsigned char *pixel: where the bytes are stored
+ * Return:     None
+ * Expects:    Pb and Pr to be within +-ONE / 2
+ * Notes:      the coefficients are pixelToRGB()'s with COEFFICIENT_BITS
+ *             fraction bits
+ */
+static void fixedToBytes(int32_t Y, int32_t Pb, int32_t Pr,
+                         unsigned char *pixel)
+{
+        static const int32_t redPr = 22970;    /* 1.402 */
+        static const int32_t greenPb = 5638;   /* 0.344136 */
+        static const int32_t greenPr = 11700;  /* 0.714136 */
+        static const int32_t bluePb = 29032;   /* 1.772 */
+        int32_t half = 1 << (COEFFICIENT_BITS - 1);
+
+        pixel[0] = scaleByte(Y + ((redPr * Pr + half) >> COEFFICIENT_BITS));
+        pixel[1] = scaleByte(Y - ((greenPb * Pb + greenPr * Pr + half) >>
+                                  COEFFICIENT_BITS));
+        pixel[2] = scaleByte(Y + ((bluePb * Pb + half) >> COEFFICIENT_BITS));
+}
+
+/*
+ * Name:       scaleByte
+ * Purpose:    a private function that clamps a fixed-point color value to
+ *             [0, 1] and scales it to a byte
+ * Parameters: int32_t value: the color value
+ * Return:     the value times 255, rounded to nearest
+ * Expects:    None
+ * Notes:      None
+ */
+static unsigned char scaleByte(int32_t value)
+{
+        uint32_t clamped = clampFixed(value, 0, ONE);
+        return (clamped * 255 + ONE / 2) >> FRACTION_BITS;
+}
+
+/*
+ * Name:       clampFixed
+ * Purpose:    a private function that fits a value within a range
+ * Parameters: int32_t value: the value to clamp
+ *             int32_t min: the minimum value in the range
+ *             int32_t max: the maximum value in the range
+ * Return:     value clamped to the range
+ * Expects:    min <= max
+ * Notes:      None
+ */
+static int32_t clampFixed(int32_t value, int32_t min, int32_t max)
+{
+        if (value < min) {
+                return min;
+        }
+        if (value > max) {
+                return max;
+        }
+        return value;
+}
+
+/*
+ * Name:       difference
+ * Purpose:    a private function that finds how far apart two values are
+ * Parameters: int first, second: the values
+ * Return:     the absolute difference
+ * Expects:    None
+ * Notes:      None
+ */
+static unsigned difference(int first, int second)
+{
+        return first > second ? first - second : second - first;
+}
+
+/*
+ * Name:       addMismatch
+ * Purpose:    a private function that adds what one check found to the
+ *             report
+ * Parameters: const struct Mismatch *found: what the check found
+ * Return:     None
+ * Expects:    found to not be NULL
+ * Notes:      locks the report, so checks can run on several threads
+ */
+static void addMismatch(const struct Mismatch *found)
+{
+        pthread_mutex_lock(&reportLock);
+        report.words += found->words;
+        report.wordsDiffer += found->wordsDiffer;
+        for (int i = 0; i < 6; i++) {
+                if (found->fields[i] > report.fields[i]) {
+                        report.fields[i] = found->fields[i];
+                }
+        }
+        report.bytes += found->bytes;
+        report.bytesDiffer += found->bytesDiffer;
+        if (found->byte > report.byte) {
+                report.byte = found->byte;
+        }
+        pthread_mutex_unlock(&reportLock);
+}
@@ -0,0 +1,43 @@
+/**************************************************************
+ *                     fixedPoint.h
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the function declarations for fixedPoint.c, the
+ *     fixed-point engine (--fixed). It compresses and decompresses rows of
+ *     blocks like the row functions of codeword.c, but does the color
+ *     conversion, the 2x2 transform, and quantization in 32-bit integer
+ *     arithmetic instead of float. Its results can differ from the float
+ *     engine's by a rounding step, so the check functions compare the two
+ *     and printFixedReport() says by how much they differed (--fixed-report).
+ *
+ **************************************************************/
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "pnm.h"
+
+void fixedRowsToWords(const struct Pnm_rgb *top, const struct Pnm_rgb *bottom,
+                      unsigned count, unsigned denominator, uint32_t *words);
+void fixedWordsToBytes(const uint32_t *words, unsigned count,
+                       unsigned char *top, unsigned char *bottom);
+void fixedWordsToPreviewBytes(const uint32_t *words, unsigned count,
+                              unsigned char *pixels);
+
+void checkFixedWords(const struct Pnm_rgb *top, const struct Pnm_rgb *bottom,
+                     unsigned count, unsigned denominator,
+                     const uint32_t *words);
+void checkFixedBytes(const uint32_t *words, unsigned count,
+                     const unsigned char *top, const unsigned char *bottom);
+void checkFixedPreview(const uint32_t *words, unsigned count,
+                       const unsigned char *pixels);
+void printFixedReport(FILE *output);
+
+#endif
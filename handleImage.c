@@ -16,88 +16,135 @@
 #include "handleImage.h"
 #include "a2plain.h"
 #include "a2methods.h"
+#include "a2extended.h"
+#include "ppmStream.h"
 #include "assert.h"
 #include <stdio.h>
 #include <stdlib.h>
-#include "bitpack.h"
+#include <sys/types.h>
+#include <unistd.h>
 
 const int BYTES_PER_WORD = 4;
 
+/* code words swapped into a buffer per fwrite() by printWords(); a
+   #define so the buffer is an array of fixed size, not a VLA */
+#define WORD_CHUNK 4096
+
+static void wordsFromBytes(const unsigned char *bytes, uint32_t *words,
+                           size_t count);
+
 /*
  * Name:       readInPPM
  * Purpose:    Reads in a PPM and trims it to have an even width and height.
  * Parameters: FILE *input: A pointer to an open file stream beginning at the
- *             start of a valid PPM readable by Pnm_ppmread. Represents the
- *             PPM to be read.
+ *             start of a raw (P6) or plain (P3) PPM. Represents the PPM to
+ *             be read.
  * Return:     a pointer to a Pnm_ppm struct containing the image data stored
  *             in the given file
  * Expects:    input to not be NULL
- * Notes:      will CRE if input is NULL, or if the read PPM is NULL
- *             Pnm_ppmread will raise an exception if the PPM is not able
- *             to be read
- *             Allocates memory for two Pnm_ppm structs (original, destination)
- *             Frees the memory for original, but the caller is responsible
- *             for freeing the memory allocated for destination with 
- *             Pnm_ppmfree()
+ * Notes:      will CRE if input is NULL or if memory cannot be allocated
+ *             raises Pnm_Badformat if the PPM is not able to be read, or if
+ *             a sample is larger than its maximum color value
+ *             The pixels are parsed straight into a UArray2 of the trimmed
+ *             size: the last column of an odd-width image is read and
+ *             dropped, and the last row of an odd-height image is never
+ *             read. 8-bit and 16-bit samples are both read directly.
+ *             Allocates memory for a Pnm_ppm struct that the caller is
+ *             responsible for freeing with Pnm_ppmfree()
  */
 Pnm_ppm readInPPM(FILE *input)
 {
         assert(input != NULL);
+        unsigned width, height, denominator;
+        enum PPM_format format =
+                readPPMHeader(input, &width, &height, &denominator);
+
         A2Methods_T methods = uarray2_methods_plain;
-        assert(methods != NULL);
-        Pnm_ppm original = Pnm_ppmread(input, methods);
-        assert(original != NULL);
+        Pnm_ppm image = malloc(sizeof(*image));
+        assert(image != NULL);
 
-        Pnm_ppm destination = trimImage(original);
+        image->width = width - (width % 2);
+        image->height = height - (height % 2);
+        image->denominator = denominator;
+        image->methods = methods;
+        image->pixels = methods->new(image->width, image->height,
+                                     sizeof(struct Pnm_rgb));
+        if (image->width == 0) {
+                return image;
+        }
 
-        Pnm_ppmfree(&original);
+        Pnm_rgb rowCopy = malloc(image->width * sizeof(struct Pnm_rgb));
+        assert(rowCopy != NULL);
 
-        return destination;
-}
+        struct Input_source source;
+        if (format == PPM_RAW) {
+                openInputSource(input, &source);
+        }
 
-/*
- * Name:       trimImage
- * Purpose:    Trims the last row/column of a given PPM so it has an even
- *             width and height
- * Parameters: Pnm_ppm original: a pointer Pnm_ppm struct representing
- *             an image stored as a PPM
- * Return:     a pointer to a Pnm_ppm struct containing trimmed image data
- * Expects:    original to not be NULL
- * Notes:      will CRE if original is NULL
- *             will CRE if trimmed_image fails to malloc or methods->new() 
- *             fails.
- *             Allocates memory for a Pnm_ppm struct that the caller is
- *             responsible for freeing using Pnm_ppmfree().
- */
-Pnm_ppm trimImage(Pnm_ppm original)
-{
-        assert(original != NULL);
-        int trimmed_height = original->height - (original->height % 2);
-        int trimmed_width = original->width - (original->width % 2);
+        for (unsigned row = 0; row < image->height; row++) {
+                struct A2Span span = A2Span_new(methods, image->pixels, 0,
+                                                row, image->width);
+                Pnm_rgb pixels = rowCopy;
+                if (span.base != NULL &&
+                    span.stride == sizeof(struct Pnm_rgb)) {
+                        pixels = (Pnm_rgb) span.base;
+                }
 
-        Pnm_ppm trimmed_image = malloc(sizeof(*trimmed_image));
-        assert(trimmed_image != NULL);
+                if (format == PPM_RAW) {
+                        readPPMRow(&source, width, image->width,
+                                   denominator, pixels);
+                } else {
+                        readPlainPPMRow(input, width, image->width,
+                                        denominator, pixels);
+                }
 
-        trimmed_image->height = trimmed_height;
-        trimmed_image->width = trimmed_width;
-        trimmed_image->denominator = original->denominator;
-        trimmed_image->methods = original->methods;
+                if (pixels == rowCopy) {
+                        for (unsigned col = 0; col < image->width; col++) {
+                                *(Pnm_rgb) A2Span_at(&span, col) =
+                                        rowCopy[col];
+                        }
+                }
+        }
 
-        trimmed_image->pixels = trimmed_image->methods->new(
-                trimmed_width, trimmed_height, sizeof(struct Pnm_rgb));
+        if (format == PPM_RAW) {
+                closeInputSource(&source);
+        }
+        free(rowCopy);
 
-        for (int row = 0; row < trimmed_height; row++) {
-                for (int col = 0; col < trimmed_width; col++) {
-                        Pnm_rgb new_pixel = trimmed_image->methods->at(
-                                trimmed_image->pixels, col, row);
-                        Pnm_rgb old_pixel = original->methods->at(
-                                original->pixels, col, row);
+        return image;
+}
 
-                        *new_pixel = *old_pixel;
-                }
+/*
+ * Name:       imagePixels
+ * Purpose:    Gets a run of pixels from one row of an image as an array
+ * Parameters: Pnm_ppm image: the image holding the pixels
+ *             unsigned col, row: the first pixel of the run
+ *             unsigned count: the number of pixels in the run
+ *             Pnm_rgb copy: room for count pixels, used if the run is not
+ *             stored as an array in the image
+ * Return:     a pointer to the count pixels of the run
+ * Expects:    image and copy to not be NULL and the run to be inside the
+ *             image
+ * Notes:      will CRE if image or copy is NULL, or if the run is not
+ *             inside the image
+ *             Points straight into the image when its methods store the
+ *             run contiguously, as readInPPM()'s do, so the pixels are
+ *             only copied for other methods
+ */
+const struct Pnm_rgb *imagePixels(Pnm_ppm image, unsigned col, unsigned row,
+                                  unsigned count, Pnm_rgb copy)
+{
+        assert(image != NULL && copy != NULL);
+        struct A2Span span = A2Span_new(image->methods, image->pixels, col,
+                                        row, count);
+        if (span.base != NULL && span.stride == sizeof(struct Pnm_rgb)) {
+                return (Pnm_rgb) span.base;
         }
 
-        return trimmed_image;
+        for (unsigned i = 0; i < count; i++) {
+                copy[i] = *(Pnm_rgb) A2Span_at(&span, i);
+        }
+        return copy;
 }
 
 /*
@@ -109,49 +156,140 @@ Pnm_ppm trimImage(Pnm_ppm original)
  *             struct that contains pointers to functions on can use on a 
  *             UArray2
  * Return:     None
- * Expects:    None
- * Notes:      Prints out a compressed image to stdout
+ * Expects:    methods to be one of our extended suites
+ * Notes:      Prints out a compressed image to stdout one row of code words
+ *             at a time. Rows that are not stored contiguously are copied
+ *             into a temporary row first.
  */
 void printCompressedImage(A2Methods_UArray2 image,
                           const struct A2Methods_T *methods)
 {
-        printf("COMP40 Compressed image format 2\n%u %u\n",
-               methods->width(image) * 2, methods->height(image) * 2);
-        methods->map_row_major(image, printWordApply, NULL);
+        int wordsWidth = methods->width(image);
+        int wordsHeight = methods->height(image);
+
+        printCompressedHeader(FORMAT_ROWS, wordsWidth * 2, wordsHeight * 2);
+        if (wordsWidth == 0) {
+                return;
+        }
+
+        uint32_t *rowCopy = malloc(wordsWidth * sizeof(uint32_t));
+        assert(rowCopy != NULL);
+
+        for (int row = 0; row < wordsHeight; row++) {
+                struct A2Span span =
+                        A2Span_new(methods, image, 0, row, wordsWidth);
+                if (span.base != NULL && span.stride == sizeof(uint32_t)) {
+                        printWords((uint32_t *) span.base, wordsWidth);
+                        continue;
+                }
+
+                for (int col = 0; col < wordsWidth; col++) {
+                        rowCopy[col] = *(uint32_t *) A2Span_at(&span, col);
+                }
+                printWords(rowCopy, wordsWidth);
+        }
+
+        free(rowCopy);
+}
+
+/*
+ * Name:       printCompressedHeader
+ * Purpose:    prints out the header of a compressed image to stdout
+ * Parameters: enum Compressed_format format: the format of the image
+ *             unsigned width: the width of the (trimmed) image in pixels
+ *             unsigned height: the height of the (trimmed) image in pixels
+ * Return:     None
+ * Expects:    width and height to be even
+ * Notes:      for FORMAT_ROWS the codewords must be printed right after the
+ *             header; FORMAT_TILED has more header after it (see tiled.c)
+ */
+void printCompressedHeader(enum Compressed_format format, unsigned width,
+                           unsigned height)
+{
+        char header[64];
+        formatCompressedHeader(header, sizeof(header), format, width, height);
+        fputs(header, stdout);
+}
+
+/*
+ * Name:       formatCompressedHeader
+ * Purpose:    stores the header of a compressed image in a string
+ * Parameters: char *buffer: where the header is stored, with a '\0' after
+ *             size_t size: the number of bytes buffer has room for
+ *             enum Compressed_format format: the format of the image
+ *             unsigned width: the width of the (trimmed) image in pixels
+ *             unsigned height: the height of the (trimmed) image in pixels
+ * Return:     the length of the header in bytes, not counting the '\0'
+ * Expects:    buffer to not be NULL; 64 bytes are always enough
+ * Notes:      will CRE if buffer is NULL or too small
+ *             the same bytes printCompressedHeader() prints
+ */
+size_t formatCompressedHeader(char *buffer, size_t size,
+                              enum Compressed_format format, unsigned width,
+                              unsigned height)
+{
+        assert(buffer != NULL);
+        int length = snprintf(buffer, size,
+                              "COMP40 Compressed image format %u\n%u %u\n",
+                              (unsigned) format, width, height);
+        assert(length >= 0 && (size_t) length < size);
+        return length;
+}
+
+/*
+ * Name:       printWords
+ * Purpose:    Prints out an array of 32-bit code words to stdout, each in
+ *             big-endian order
+ * Parameters: const uint32_t *words: the code words to be printed
+ *             size_t count: the number of code words in words
+ * Returns:    None
+ * Expects:    words to not be NULL unless count is 0
+ * Notes:      will CRE if words is NULL and count is not 0, or if stdout
+ *             cannot be written to.
+ *             Swaps up to WORD_CHUNK words at a time into a byte buffer
+ *             with storeWords() and writes it with one fwrite(), instead of
+ *             one putchar() per byte.
+ */
+void printWords(const uint32_t *words, size_t count)
+{
+        assert(words != NULL || count == 0);
+        unsigned char bytes[WORD_CHUNK * sizeof(uint32_t)];
+
+        for (size_t first = 0; first < count; first += WORD_CHUNK) {
+                size_t chunk = count - first < WORD_CHUNK ? count - first
+                                                          : WORD_CHUNK;
+                storeWords(bytes, words + first, chunk);
+
+                size_t written = fwrite(bytes, BYTES_PER_WORD, chunk, stdout);
+                assert(written == chunk);
+        }
 }
 
 /*
- * Name:       printWordApply
- * Purpose:    Prints out a single 32-bit code word to stdout in big-endian 
- *             order
- * Parameters: int col: required by the A2Methods_Object interface; ignored 
- *             here
- *             int row: required by the A2Methods_Object interface; ignored 
- *             here
- *             A2Methods_UArray2 array2: required by the A2Methods_Object
- *             interface; ignored here
- *             A2Methods_Object *elem: a 32-bit integer representing a 32-bit
- *             code word to be printed to stdout
- *             void *cl: required by the A2Methods_Object interface; ignored 
- *             here
+ * Name:       storeWords
+ * Purpose:    Stores an array of 32-bit code words in memory the way they
+ *             are printed: each in big-endian order
+ * Parameters: unsigned char *bytes: where the code words are stored
+ *             const uint32_t *words: the code words to store
+ *             size_t count: the number of code words in words
  * Returns:    None
- * Expects:    elem to not be NULL and stores a 32-bit integer
- * Notes:      will CRE if elem is NULL
+ * Expects:    bytes to have room for count code words, and bytes and words
+ *             to not be NULL unless count is 0
+ * Notes:      will CRE if bytes or words is NULL and count is not 0
+ *             The swap loop is written byte by byte so it works on any
+ *             host; the compiler turns it into bswap instructions.
  */
-void printWordApply(int col, int row, A2Methods_UArray2 array2,
-                    A2Methods_Object *elem, void *cl)
+void storeWords(unsigned char *bytes, const uint32_t *words, size_t count)
 {
-        assert(elem != NULL);
-        uint32_t *word = elem;
-        putchar(Bitpack_getu(*word, 8, 24));
-        putchar(Bitpack_getu(*word, 8, 16));
-        putchar(Bitpack_getu(*word, 8, 8));
-        putchar(Bitpack_getu(*word, 8, 0));
-
-        (void) col;
-        (void) row;
-        (void) array2;
-        (void) cl;
+        assert((bytes != NULL && words != NULL) || count == 0);
+        for (size_t i = 0; i < count; i++) {
+                uint32_t word = words[i];
+                unsigned char *out = &bytes[i * BYTES_PER_WORD];
+                out[0] = word >> 24;
+                out[1] = word >> 16;
+                out[2] = word >> 8;
+                out[3] = word;
+        }
 }
 
 /*
@@ -164,41 +302,198 @@ void printWordApply(int col, int row, A2Methods_UArray2 array2,
  *             struct that contains pointers to functions on can use on a 
  *             UArray2
  * Return:     a pointer to a A2Methods_UArray2 struct storing 32-bit codewords
- * Expects:    input to not be NULL and the file to contain enough codewords
- *             for the given width and height
- * Notes:      will CRE if input is NULL or if methods-new() fails
+ * Expects:    input to not be NULL, the image to be in FORMAT_ROWS, and the
+ *             file to contain enough codewords for the given width and
+ *             height
+ * Notes:      will CRE if input is NULL, if the image is not in
+ *             FORMAT_ROWS, or if methods-new() fails
  */
 A2Methods_UArray2 readInCompressed(FILE *input,
                                    const struct A2Methods_T *methods)
 {
         assert(input != NULL);
         unsigned height, width;
-        int read = fscanf(input, "COMP40 Compressed image format 2\n%u %u",
-                          &width, &height);
-        assert(read == 2);
-        int c = getc(input);
-        assert(c == '\n');
+        enum Compressed_format format =
+                readCompressedHeader(input, &width, &height);
+        assert(format == FORMAT_ROWS);
+
+        return readCompressedWords(input, width, height, methods);
+}
 
+/*
+ * Name:       readCompressedWords
+ * Purpose:    reads in the code words of a FORMAT_ROWS compressed image
+ *             whose header has already been read
+ * Parameters: FILE *input: A pointer to an open file stream positioned at
+ *             the first code word
+ *             unsigned width: the width of the image from the header
+ *             unsigned height: the height of the image from the header
+ *             const struct A2Methods_T *methods: the methods used for the
+ *             array of code words
+ * Return:     a pointer to a A2Methods_UArray2 struct storing 32-bit codewords
+ * Expects:    input and methods to not be NULL and the file to contain
+ *             enough codewords for the given width and height
+ * Notes:      will CRE if input is NULL or if methods-new() fails
+ *             Reads one row of code words at a time with readWords(),
+ *             straight into the array when the row is stored contiguously.
+ *             A regular file is memory-mapped after its header.
+ */
+A2Methods_UArray2 readCompressedWords(FILE *input, unsigned width,
+                                      unsigned height,
+                                      const struct A2Methods_T *methods)
+{
+        assert(input != NULL && methods != NULL);
         unsigned wordsHeight = height / 2;
         unsigned wordsWidth = width / 2;
         A2Methods_UArray2 words =
                 methods->new(wordsWidth, wordsHeight, sizeof(uint32_t));
+        if (wordsWidth == 0) {
+                return words;
+        }
+
+        uint32_t *rowCopy = malloc(wordsWidth * sizeof(uint32_t));
+        assert(rowCopy != NULL);
+
+        struct Input_source source;
+        openInputSource(input, &source);
 
         for (unsigned row = 0; row < wordsHeight; row++) {
+                struct A2Span span =
+                        A2Span_new(methods, words, 0, row, wordsWidth);
+                if (span.base != NULL && span.stride == sizeof(uint32_t)) {
+                        readWords(&source, (uint32_t *) span.base,
+                                  wordsWidth);
+                        continue;
+                }
+
+                readWords(&source, rowCopy, wordsWidth);
                 for (unsigned col = 0; col < wordsWidth; col++) {
-                        uint32_t word = 0;
-                        for (int byte = BYTES_PER_WORD - 1; byte >= 0; byte--) {
-                                c = getc(input);
-                                assert(c != EOF);
-                                word = Bitpack_newu(word, 8, byte * 8, c);
-                        }
+                        *(uint32_t *) A2Span_at(&span, col) = rowCopy[col];
+                }
+        }
+
+        closeInputSource(&source);
+        free(rowCopy);
+        return words;
+}
+
+/*
+ * Name:       readCompressedHeader
+ * Purpose:    reads in the format and size lines of a compressed image
+ * Parameters: FILE *input: A pointer to an open file stream beginning at the
+ *             start of a compressed image.
+ *             unsigned *width: a pointer to where the image width is stored
+ *             unsigned *height: a pointer to where the image height is stored
+ * Return:     the format of the image
+ * Expects:    input, width, and height to not be NULL and the header to be
+ *             well formed, with an even width and height
+ * Notes:      will CRE if any pointer is NULL, the header is malformed, the
+ *             format is not one we know, or the width or height is odd,
+ *             which compress40() never writes and which would leave every
+ *             decoder a half block past the code words
+ *             leaves input at the first byte after the size line, which is
+ *             the first code word of a FORMAT_ROWS image
+ */
+enum Compressed_format readCompressedHeader(FILE *input, unsigned *width,
+                                            unsigned *height)
+{
+        assert(input != NULL && width != NULL && height != NULL);
+        unsigned format;
+        int read = fscanf(input, "COMP40 Compressed image format %u\n%u %u",
+                          &format, width, height);
+        assert(read == 3);
+        assert(format == FORMAT_ROWS || format == FORMAT_TILED);
+        assert(*width % 2 == 0 && *height % 2 == 0);
+        int c = getc(input);
+        assert(c == '\n');
+        return format;
+}
+
+/*
+ * Name:       readWords
+ * Purpose:    reads in an array of 32-bit code words, each stored in
+ *             big-endian order
+ * Parameters: struct Input_source *input: the source positioned at the
+ *             start of a code word
+ *             uint32_t *words: where the code words are stored
+ *             size_t count: the number of code words to read
+ * Return:     None
+ * Expects:    input to not be NULL, words to not be NULL unless count is 0,
+ *             and input to hold at least count more code words
+ * Notes:      will CRE if input or words is NULL, or if input ends before
+ *             count code words are read.
+ *             Gets all of the bytes at once and checks the length once,
+ *             then swaps each word into host order. A mapped input is
+ *             swapped straight out of the mapping; otherwise the bytes are
+ *             read into words with one fread() and swapped in place.
+ */
+void readWords(struct Input_source *input, uint32_t *words, size_t count)
+{
+        assert(input != NULL && (words != NULL || count == 0));
+        const unsigned char *bytes = readInputBytes(
+                input, (unsigned char *) words, count * BYTES_PER_WORD);
+        assert(bytes != NULL);
+
+        wordsFromBytes(bytes, words, count);
+}
 
-                        uint32_t *currWordElement =
-                                methods->at(words, col, row);
+/*
+ * Name:       readWordsAt
+ * Purpose:    reads in an array of 32-bit code words, each stored in
+ *             big-endian order, from a given offset of a file
+ * Parameters: FILE *input: the file to read from
+ *             off_t offset: the offset in bytes of the first code word
+ *             uint32_t *words: where the code words are stored
+ *             size_t count: the number of code words to read
+ * Return:     true if all count code words were read, and false if the
+ *             file ends or a read fails first
+ * Expects:    input to not be NULL and to be a file that can be read at
+ *             any offset, and words to not be NULL unless count is 0
+ * Notes:      will CRE if input or words is NULL
+ *             Uses pread(), so neither input's position nor its stdio
+ *             buffer is touched, and does not raise when the read comes up
+ *             short, so it can be called from a task of runParallel().
+ */
+bool readWordsAt(FILE *input, off_t offset, uint32_t *words, size_t count)
+{
+        assert(input != NULL && (words != NULL || count == 0));
+        int fd = fileno(input);
+        unsigned char *bytes = (unsigned char *) words;
+        size_t length = count * BYTES_PER_WORD;
 
-                        *currWordElement = word;
+        size_t done = 0;
+        while (done < length) {
+                ssize_t got = pread(fd, bytes + done, length - done,
+                                    offset + (off_t) done);
+                if (got <= 0) {
+                        return false;
                 }
+                done += got;
         }
 
-        return words;
-}
\ No newline at end of file
+        wordsFromBytes(bytes, words, count);
+        return true;
+}
+
+/*
+ * Name:       wordsFromBytes
+ * Purpose:    a private function that turns big-endian code words into
+ *             host order
+ * Parameters: const unsigned char *bytes: the code words as stored
+ *             uint32_t *words: where the code words are stored; may be the
+ *             same memory as bytes
+ *             size_t count: the number of code words
+ * Return:     None
+ * Expects:    bytes and words to not be NULL unless count is 0
+ * Notes:      The swap is written byte by byte so it works on any host;
+ *             the compiler turns it into bswap instructions.
+ */
+static void wordsFromBytes(const unsigned char *bytes, uint32_t *words,
+                           size_t count)
+{
+        for (size_t i = 0; i < count; i++) {
+                const unsigned char *in = &bytes[i * BYTES_PER_WORD];
+                words[i] = (uint32_t) in[0] << 24 | (uint32_t) in[1] << 16 |
+                           (uint32_t) in[2] << 8 | in[3];
+        }
+}
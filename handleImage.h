@@ -16,17 +16,46 @@
 #ifndef HANDLE_IMAGE_H
 #define HANDLE_IMAGE_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
 #include "pnm.h"
+#include "inputSource.h"
+
+/*
+ * Name:       Compressed_format
+ * Purpose:    The versions of the compressed image format, numbered as they
+ *             are in the first line of the header
+ * Components: 
+ *             FORMAT_ROWS: every code word in row-major order right after
+ *             the header
+ *             FORMAT_TILED: the code words split into tiles, with an index
+ *             of where each tile is stored (see tiled.h)
+ */
+enum Compressed_format { FORMAT_ROWS = 2, FORMAT_TILED = 3 };
 
 Pnm_ppm readInPPM(FILE *input);
-Pnm_ppm trimImage(Pnm_ppm original);
+const struct Pnm_rgb *imagePixels(Pnm_ppm image, unsigned col, unsigned row,
+                                  unsigned count, Pnm_rgb copy);
 
 void printCompressedImage(A2Methods_UArray2 image,
                           const struct A2Methods_T *methods);
+void printCompressedHeader(enum Compressed_format format, unsigned width,
+                           unsigned height);
+size_t formatCompressedHeader(char *buffer, size_t size,
+                              enum Compressed_format format, unsigned width,
+                              unsigned height);
 
-void printWordApply(int col, int row, A2Methods_UArray2 array2,
-                    A2Methods_Object *elem, void *cl);
+void printWords(const uint32_t *words, size_t count);
+void storeWords(unsigned char *bytes, const uint32_t *words, size_t count);
 
 A2Methods_UArray2 readInCompressed(FILE *input,
                                    const struct A2Methods_T *methods);
+A2Methods_UArray2 readCompressedWords(FILE *input, unsigned width,
+                                      unsigned height,
+                                      const struct A2Methods_T *methods);
+enum Compressed_format readCompressedHeader(FILE *input, unsigned *width,
+                                            unsigned *height);
+void readWords(struct Input_source *input, uint32_t *words, size_t count);
+bool readWordsAt(FILE *input, off_t offset, uint32_t *words, size_t count);
 #endif
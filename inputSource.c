@@ -0,0 +1,179 @@
+/**************************************************************
+ *                     inputSource.c
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the implementations for the functions declared
+ *     in inputSource.h. The header of an input is always parsed with
+ *     stdio; openInputSource() then maps the whole file and starts handing
+ *     out bytes at the position stdio had reached, so no byte is copied
+ *     through a stdio buffer on its way to the codec.
+ *
+ **************************************************************/
+#include "inputSource.h"
+#include "assert.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* bytes read per fread() by skipInputBytes() on an input that is not
+   mapped; a #define so its buffer is an array of fixed size, not a VLA */
+#define SKIP_CHUNK 4096
+
+/*
+ * Name:       openInputSource
+ * Purpose:    Gets ready to hand out the rest of an input, memory-mapping
+ *             it if it is a regular file
+ * Parameters: FILE *input: A pointer to an open file stream positioned just
+ *             after the header
+ *             struct Input_source *source: the source to set up
+ * Return:     None
+ * Expects:    input and source to not be NULL
+ * Notes:      will CRE if input or source is NULL
+ *             Falls back to reading input with stdio if it is not a regular
+ *             file, is empty, or cannot be mapped.
+ *             The caller must call closeInputSource() when done, and must
+ *             not read input with stdio in between.
+ */
+void openInputSource(FILE *input, struct Input_source *source)
+{
+        assert(input != NULL && source != NULL);
+        source->file = input;
+        source->mapping = NULL;
+        source->mappingLength = 0;
+        source->next = NULL;
+        source->end = NULL;
+
+        struct stat info;
+        long position = ftell(input);
+        if (position < 0 || fstat(fileno(input), &info) != 0 ||
+            !S_ISREG(info.st_mode) || info.st_size <= position) {
+                return;
+        }
+
+        void *mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE,
+                             fileno(input), 0);
+        if (mapping == MAP_FAILED) {
+                return;
+        }
+        madvise(mapping, info.st_size, MADV_SEQUENTIAL);
+
+        source->mapping = mapping;
+        source->mappingLength = info.st_size;
+        source->next = (const unsigned char *) mapping + position;
+        source->end = (const unsigned char *) mapping + info.st_size;
+}
+
+/*
+ * Name:       readInputBytes
+ * Purpose:    Hands out the next count bytes of an input
+ * Parameters: struct Input_source *source: the source to read from
+ *             unsigned char *buffer: where the bytes are read to when the
+ *             input is not mapped
+ *             size_t count: the number of bytes to hand out
+ * Return:     a pointer to the bytes (inside the mapping, or buffer), or
+ *             NULL if the input ends before count bytes
+ * Expects:    source to not be NULL and buffer to hold count bytes; buffer
+ *             may be NULL when count is 0
+ * Notes:      will CRE if source is NULL, or if buffer is NULL and count
+ *             is not 0
+ *             The bytes stay valid until the next call or until
+ *             closeInputSource(), whichever comes first
+ */
+const unsigned char *readInputBytes(struct Input_source *source,
+                                    unsigned char *buffer, size_t count)
+{
+        static const unsigned char none[1];
+
+        assert(source != NULL);
+        assert(buffer != NULL || count == 0);
+        if (count == 0) {
+                /* nothing to read, but NULL would mean the input ended */
+                return buffer != NULL ? buffer : none;
+        }
+        if (source->mapping == NULL) {
+                if (fread(buffer, 1, count, source->file) != count) {
+                        return NULL;
+                }
+                return buffer;
+        }
+
+        if ((size_t) (source->end - source->next) < count) {
+                return NULL;
+        }
+        const unsigned char *bytes = source->next;
+        source->next += count;
+        return bytes;
+}
+
+/*
+ * Name:       skipInputBytes
+ * Purpose:    Skips over the next count bytes of an input
+ * Parameters: struct Input_source *source: the source to read from
+ *             size_t count: the number of bytes to skip
+ * Return:     true if count bytes were skipped, false if the input ends
+ *             first
+ * Expects:    source to not be NULL
+ * Notes:      will CRE if source is NULL
+ *             An input that is not mapped is read through a small buffer,
+ *             so this works on pipes too
+ */
+bool skipInputBytes(struct Input_source *source, size_t count)
+{
+        assert(source != NULL);
+        unsigned char buffer[SKIP_CHUNK];
+        while (count > 0) {
+                size_t chunk = count < SKIP_CHUNK ? count : SKIP_CHUNK;
+                if (readInputBytes(source, buffer, chunk) == NULL) {
+                        return false;
+                }
+                count -= chunk;
+        }
+        return true;
+}
+
+/*
+ * Name:       inputBytesLeft
+ * Purpose:    Finds how many bytes of an input have not been handed out,
+ *             when that can be known without reading them
+ * Parameters: const struct Input_source *source: the source to check
+ *             size_t *left: where the number of bytes is stored
+ * Return:     true if the input is mapped and *left was set, false if it
+ *             is not (a pipe, for example), in which case *left is not
+ *             changed
+ * Expects:    source and left to not be NULL
+ * Notes:      will CRE if source or left is NULL
+ *             lets a decoder check that the whole input is there before
+ *             it prints anything
+ */
+bool inputBytesLeft(const struct Input_source *source, size_t *left)
+{
+        assert(source != NULL && left != NULL);
+        if (source->mapping == NULL) {
+                return false;
+        }
+        *left = source->end - source->next;
+        return true;
+}
+
+/*
+ * Name:       closeInputSource
+ * Purpose:    Unmaps an input, if it was mapped
+ * Parameters: struct Input_source *source: the source to close
+ * Return:     None
+ * Expects:    source to not be NULL and to have been opened
+ * Notes:      will CRE if source is NULL
+ *             does not close source->file; the caller still owns it
+ */
+void closeInputSource(struct Input_source *source)
+{
+        assert(source != NULL);
+        if (source->mapping != NULL) {
+                munmap(source->mapping, source->mappingLength);
+                source->mapping = NULL;
+        }
+}
@@ -0,0 +1,51 @@
+/**************************************************************
+ *                     inputSource.h
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the interface for an Input_source, which hands
+ *     out the bytes of an input file that come after its header. A
+ *     regular file is memory-mapped so its bytes are used in place; a
+ *     pipe or terminal is read through stdio instead.
+ *
+ **************************************************************/
+#ifndef INPUT_SOURCE_H
+#define INPUT_SOURCE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/*
+ * Name:       Input_source
+ * Purpose:    Where the rest of an input comes from
+ * Components: 
+ *             FILE *file: the input, used when it could not be mapped
+ *             void *mapping: what mmap() returned, or NULL
+ *             size_t mappingLength: the length of the mapping in bytes
+ *             const unsigned char *next: the next byte of the mapping to
+ *             hand out
+ *             const unsigned char *end: one past the last byte of the
+ *             mapping
+ */
+struct Input_source {
+        FILE *file;
+        void *mapping;
+        size_t mappingLength;
+        const unsigned char *next;
+        const unsigned char *end;
+};
+
+void openInputSource(FILE *input, struct Input_source *source);
+const unsigned char *readInputBytes(struct Input_source *source,
+                                    unsigned char *buffer, size_t count);
+bool skipInputBytes(struct Input_source *source, size_t count);
+bool inputBytesLeft(const struct Input_source *source, size_t *left);
+void closeInputSource(struct Input_source *source);
+
+#endif
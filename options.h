@@ -0,0 +1,94 @@
+/**************************************************************
+ *                     options.h
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the declaration of the options that change how
+ *     compress40() and decompress40() do their work. Apart from tiled,
+ *     region, preview, and fixedPoint, they never change the bytes that
+ *     are written out. They are set by 40image.c from the command line.
+ *
+ **************************************************************/
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <stdbool.h>
+
+/* the most threads -j runs; a larger -j is cut down to it */
+enum { MAX_THREADS = 256 };
+
+/*
+ * Name:       Region
+ * Purpose:    A rectangle of pixels in an image
+ * Components: 
+ *             unsigned x, y: the column and row of its top-left pixel
+ *             unsigned width, height: its size in pixels
+ */
+struct Region {
+        unsigned x, y;
+        unsigned width, height;
+};
+
+/*
+ * Name:       Options
+ * Purpose:    Stores the settings that select how an image is compressed
+ *             or decompressed
+ * Components: 
+ *             bool staged: true if each stage should be run over the
+ *             whole image, storing its result, before the next one starts,
+ *             instead of running every stage on one block at a time. Prints
+ *             the same bytes as the fused code.
+ *             bool stream: true if a raw PPM should be compressed two rows
+ *             at a time as it is read (and a compressed image decompressed
+ *             one row of code words at a time), instead of being read in
+ *             whole. Takes priority over staged.
+ *             int threads: the number of threads the fused kernels split
+ *             the image's bands of blocks across, and that the staged
+ *             pipeline's map_parallel calls use. 1 runs everything on the
+ *             calling thread. At most MAX_THREADS.
+ *             bool hasRegion: true if only region of an image should be
+ *             compressed, or only region of a compressed image should be
+ *             decompressed. Takes priority over stream, and when
+ *             decompressing over staged too.
+ *             struct Region region: the pixels to compress or decompress
+ *             when hasRegion is set
+ *             bool preview: true if a compressed image should be
+ *             decompressed to half its width and height, one pixel per
+ *             block. Takes priority over stream and staged.
+ *             bool tiled: true if an image should be compressed into the
+ *             tiled format (FORMAT_TILED) instead of format 2. Takes
+ *             priority over stream and staged.
+ *             bool checksums: true if each tile of a tiled image should
+ *             get a CRC32C checksum. Implies tiled.
+ *             const char *output: the file to write the result to, or
+ *             NULL for stdout
+ *             bool fixedPoint: true if the fixed-point engine should
+ *             compress or decompress each row of blocks instead of the
+ *             float one. Its output may differ by a rounding step, so it
+ *             changes the bytes written out. Not used by staged.
+ *             bool fixedReport: true if every row the fixed-point engine
+ *             does should be checked against the float engine, and the
+ *             differences printed to stderr at the end. Implies fixedPoint.
+ */
+struct Options {
+        bool staged;
+        bool stream;
+        int threads;
+        bool hasRegion;
+        struct Region region;
+        bool preview;
+        bool tiled;
+        bool checksums;
+        const char *output;
+        bool fixedPoint;
+        bool fixedReport;
+};
+
+extern struct Options codecOptions;
+
+#endif
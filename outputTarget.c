@@ -0,0 +1,134 @@
+/**************************************************************
+ *                     outputTarget.c
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the implementation for the functions declared
+ *     in outputTarget.h. The output file is truncated, given all of its
+ *     blocks up front with posix_fallocate() so that a full disk is found
+ *     before anything is written, and mapped shared, so the bytes stored
+ *     in the mapping are the bytes of the file. An output that is not a
+ *     regular file (/dev/null, a pipe, a fifo) cannot be sized or mapped,
+ *     so stdout is pointed at it and the caller prints through stdio.
+ *
+ **************************************************************/
+#include "outputTarget.h"
+#include "assert.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static void sendStdoutTo(int fd);
+
+/*
+ * Name:       openOutputTarget
+ * Purpose:    Creates (or empties) an output file of a given length and
+ *             maps it
+ * Parameters: const char *path: the name of the file
+ *             size_t length: the length the file will have, in bytes
+ *             struct Output_target *target: the target to set up
+ * Return:     true if the file was mapped, false if it is not a regular
+ *             file or cannot be mapped, in which case stdout has been
+ *             pointed at it instead and target is not set up
+ * Expects:    path and target to not be NULL and length to be positive
+ * Notes:      will CRE if the file cannot be opened, or if a regular file
+ *             cannot be given length bytes (a full disk)
+ *             After true, the caller must store every one of the length
+ *             bytes and then call closeOutputTarget(). After false, it
+ *             prints to stdout, just as after redirectOutput().
+ */
+bool openOutputTarget(const char *path, size_t length,
+                      struct Output_target *target)
+{
+        assert(path != NULL && target != NULL && length > 0);
+        int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0666);
+        assert(fd != -1);
+
+        struct stat info;
+        int result = fstat(fd, &info);
+        assert(result == 0);
+        if (!S_ISREG(info.st_mode)) {
+                sendStdoutTo(fd);
+                return false;
+        }
+
+        result = ftruncate(fd, length);
+        assert(result == 0);
+        result = posix_fallocate(fd, 0, length);
+        assert(result == 0);
+
+        void *mapping = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                             MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) {
+                sendStdoutTo(fd);
+                return false;
+        }
+        close(fd);
+
+        target->bytes = mapping;
+        target->length = length;
+        return true;
+}
+
+/*
+ * Name:       closeOutputTarget
+ * Purpose:    Unmaps an output file, leaving the bytes stored in it
+ * Parameters: struct Output_target *target: the target to close
+ * Return:     None
+ * Expects:    target to not be NULL and to have been opened
+ * Notes:      will CRE if target is NULL or the mapping cannot be removed
+ *             the kernel writes the pages back to the file on its own
+ */
+void closeOutputTarget(struct Output_target *target)
+{
+        assert(target != NULL);
+        int result = munmap(target->bytes, target->length);
+        assert(result == 0);
+        target->bytes = NULL;
+        target->length = 0;
+}
+
+/*
+ * Name:       redirectOutput
+ * Purpose:    Sends everything printed to stdout to a file instead
+ * Parameters: const char *path: the name of the file, which is created or
+ *             emptied
+ * Return:     None
+ * Expects:    path to not be NULL
+ * Notes:      will CRE if the file cannot be opened
+ *             used by the output paths that print as they go, whose
+ *             length is not worked out up front
+ */
+void redirectOutput(const char *path)
+{
+        assert(path != NULL);
+        FILE *output = freopen(path, "wb", stdout);
+        assert(output != NULL);
+}
+
+/*
+ * Name:       sendStdoutTo
+ * Purpose:    a private function that sends everything printed to stdout
+ *             to an open file, and closes the descriptor it was given
+ * Parameters: int fd: the open file
+ * Return:     None
+ * Expects:    fd to be open for writing
+ * Notes:      will CRE if stdout cannot be pointed at fd
+ *             the file is not opened again, so a pipe or fifo is never
+ *             closed (and its reader never sees the end) before the
+ *             output is printed
+ */
+static void sendStdoutTo(int fd)
+{
+        fflush(stdout);
+        int result = dup2(fd, STDOUT_FILENO);
+        assert(result != -1);
+        close(fd);
+}
@@ -0,0 +1,42 @@
+/**************************************************************
+ *                     outputTarget.h
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the interface for an Output_target, an output
+ *     file of a known size that is preallocated and memory-mapped so the
+ *     encoder and decoder can store their bytes straight into it, from
+ *     any thread and in any order. It also declares redirectOutput(),
+ *     which sends stdout to a file for the output paths that print
+ *     through stdio.
+ *
+ **************************************************************/
+#ifndef OUTPUT_TARGET_H
+#define OUTPUT_TARGET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Name:       Output_target
+ * Purpose:    A mapped output file
+ * Components: 
+ *             unsigned char *bytes: the first byte of the file
+ *             size_t length: the length of the file in bytes
+ */
+struct Output_target {
+        unsigned char *bytes;
+        size_t length;
+};
+
+bool openOutputTarget(const char *path, size_t length,
+                      struct Output_target *target);
+void closeOutputTarget(struct Output_target *target);
+void redirectOutput(const char *path);
+
+#endif
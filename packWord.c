@@ -15,6 +15,7 @@
  * 
  **************************************************************/
 #include "packWord.h"
+#include "a2extended.h"
 #include "assert.h"
 #include "bitpack.h"
 #include "quantize.h"
@@ -36,6 +37,8 @@ static const unsigned CHORMA_WIDTH = 4;
  *        Quantized_Block structs, which represents 2x2 blocks of pixels
  *        const struct A2Methods_T *methods: A pointer to a A2Methods_T struct
  *        that contains pointers to functions on can use on a UArray2
+ *        int threads: the number of threads to run the stage on,
+ *        counting the calling thread
  *
  * Return: a pointer to a newly allocated A2Methods_UArray2 struct storing
  *         32-bit words that represent the compressed image data
@@ -51,7 +54,7 @@ static const unsigned CHORMA_WIDTH = 4;
  *
  ************************************************************/
 A2Methods_UArray2 packWord(A2Methods_UArray2 original,
-                           const struct A2Methods_T *methods)
+                           const struct A2Methods_T *methods, int threads)
 {
         assert(original != NULL && methods != NULL);
 
@@ -61,53 +64,57 @@ A2Methods_UArray2 packWord(A2Methods_UArray2 original,
 
         struct Closure cl = { .array = original, .methods = methods };
 
-        methods->map_default(destination, packWordApply, &cl);
+        A2Extended(methods)->map_spans_parallel(destination, threads,
+                                                packWordSpan, &cl);
 
         return destination;
 }
 
 /*
- * Name:       packWordApply
+ * Name:       packWordSpan
  * Purpose:    Converts each Quantized_Block into a 32-bit packed word
  *             by bit-packing the quantized coefficients and chromas
- * Parameters: int col: an integer representing the distance between the
- *             current element and the left edge of the array
- *             int row: an integer representing the distance between the
- *             current element and the top of the array
- *             A2Methods_UArray2 array2: required by the A2Methods_Object
- *             interface; ignored here
- *             A2Methods_Object *elem: a pointer to a 32-bit word where packed
- *             data will be stored
+ * Parameters: int col: the column of the first element of the span
+ *             int row: the row of the span
+ *             int count: the number of elements in the span
+ *             A2Methods_Object *base: a pointer to the first 32-bit word of
+ *             the span, where packed data will be stored
+ *             int stride: the number of bytes from one element of
+ *             the span to the next
  *             void *cl: a pointer to a Closure struct containing a pointer
  *             to a A2Methods_UArray2 (the destination image in YPbPr_pixel
  *             format) and a pointer to an A2Methods_T struct with function
  *             pointers for operating on the array.
  * Return:     None
- * Expects:    elem to not be NULL and cl points to a Closure struct that
+ * Expects:    base to not be NULL and cl points to a Closure struct that
  *             stores a non-NULL A2Methods_UArray2 and A2Methods_T struct 
  *             and is not NULL
- *             col and row are within the bounds of the array
+ *             the span is within the bounds of the array
  * Notes:      will CRE if cl is NULL or its array or methods field is NULL
- *             will CRE if elem is NULL
- *             If col or row are out of bounds or not used by the array,
- *             the methods->at function will throw a CRE
+ *             will CRE if base is NULL
+ *             If the span is out of bounds, A2Span_new will throw
+ *             a CRE
  */
-void packWordApply(int col, int row, A2Methods_UArray2 array2, void *elem,
-                   void *cl)
+void packWordSpan(int col, int row, int count, A2Methods_Object *base,
+                  int stride, void *cl)
 {
-        assert(elem != NULL && cl != NULL);
+        assert(base != NULL && cl != NULL);
         struct Closure *closure = cl;
         assert(closure != NULL && closure->methods != NULL &&
                closure->array != NULL);
-        struct Quantized_Block *currBlock =
-                closure->methods->at(closure->array, col, row);
-        uint32_t *currWord = elem;
 
-        *currWord = bitpackWord(currBlock->a, currBlock->b, currBlock->c,
-                                currBlock->d, currBlock->avgPb,
-                                currBlock->avgPr);
+        struct A2Span original = A2Span_new(closure->methods, closure->array,
+                                            col, row, count);
+        char *words = base;
 
-        (void) array2;
+        for (int i = 0; i < count; i++) {
+                struct Quantized_Block *currBlock = A2Span_at(&original, i);
+                uint32_t *currWord = (uint32_t *) (words + (long) i * stride);
+
+                *currWord = bitpackWord(currBlock->a, currBlock->b,
+                                        currBlock->c, currBlock->d,
+                                        currBlock->avgPb, currBlock->avgPr);
+        }
 }
 
 /*
@@ -161,6 +168,8 @@ uint32_t bitpackWord(unsigned a, int b, int c, int d, unsigned avgPb,
  *        32-bit codewords representing the compressed image
  *        const struct A2Methods_T *methods: A pointer to a A2Methods_T struct
  *        that contains pointers to functions on can use on a UArray2
+ *        int threads: the number of threads to run the stage on,
+ *        counting the calling thread
  *
  * Return: a pointer to a newly allocated A2Methods_UArray2 struct storing
  *         Quantized_Block structs made from the packed data
@@ -176,7 +185,7 @@ uint32_t bitpackWord(unsigned a, int b, int c, int d, unsigned avgPb,
  *
  ************************************************************/
 A2Methods_UArray2 unpackWord(A2Methods_UArray2 original,
-                             const struct A2Methods_T *methods)
+                             const struct A2Methods_T *methods, int threads)
 {
         assert(original != NULL && methods != NULL);
 
@@ -186,53 +195,60 @@ A2Methods_UArray2 unpackWord(A2Methods_UArray2 original,
 
         struct Closure cl = { .array = original, .methods = methods };
 
-        methods->map_default(destination, unpackWordApply, &cl);
+        A2Extended(methods)->map_spans_parallel(destination, threads,
+                                                unpackWordSpan, &cl);
 
         return destination;
 }
 
 /*
- * Name:       unpackWordApply
+ * Name:       unpackWordSpan
  * Purpose:    Converts 32-bit packed word back into its component
  *             fields, storing into a Quantized_Block.
- * Parameters: int col: an integer representing the distance between the
- *             current element and the left edge of the array
- *             int row: an integer representing the distance between the
- *             current element and the top of the array
- *             A2Methods_UArray2 array2: required by the A2Methods_Object
- *             interface; ignored here
- *             A2Methods_Object *elem: a pointer to Quantized_Block struct
- *             where the unpacked data will be stored
+ * Parameters: int col: the column of the first element of the span
+ *             int row: the row of the span
+ *             int count: the number of elements in the span
+ *             A2Methods_Object *base: a pointer to the first Quantized_Block
+ *             struct of the span, where the unpacked data will be stored
+ *             int stride: the number of bytes from one element of
+ *             the span to the next
  *             void *cl: a pointer to a Closure struct containing a pointer
  *             to a A2Methods_UArray2 (the destination image in YPbPr_pixel
  *             format) and a pointer to an A2Methods_T struct with function
  *             pointers for operating on the array.
  * Return:     None
- * Expects:    elem to not be NULL and cl points to a Closure struct that
+ * Expects:    base to not be NULL and cl points to a Closure struct that
  *             stores a non-NULL A2Methods_UArray2 and A2Methods_T struct 
  *             and is not NULL
- *             col and row are within the bounds of the array
+ *             the span is within the bounds of the array
  * Notes:      will CRE if cl is NULL or its array or methods field is NULL
- *             will CRE if elem is NULL
- *             If col or row are out of bounds or not used by the array,
- *             the methods->at function will throw a CRE
+ *             will CRE if base is NULL
+ *             If the span is out of bounds, A2Span_new will throw
+ *             a CRE
  */
-void unpackWordApply(int col, int row, A2Methods_UArray2 array2, void *elem,
-                     void *cl)
+void unpackWordSpan(int col, int row, int count, A2Methods_Object *base,
+                    int stride, void *cl)
 {
-        assert(elem != NULL && cl != NULL);
+        assert(base != NULL && cl != NULL);
         struct Closure *closure = cl;
 
         assert(closure != NULL && closure->methods != NULL &&
                closure->array != NULL);
-        struct Quantized_Block *currBlock = elem;
-        uint32_t *word = closure->methods->at(closure->array, col, row);
 
-        unbitpackWord(*word, &(currBlock->a), &(currBlock->b), &(currBlock->c),
-                      &(currBlock->d), &(currBlock->avgPb),
-                      &(currBlock->avgPr));
+        struct A2Span original = A2Span_new(closure->methods, closure->array,
+                                            col, row, count);
+        char *blocks = base;
+
+        for (int i = 0; i < count; i++) {
+                struct Quantized_Block *currBlock =
+                        (struct Quantized_Block *) (blocks +
+                                                    (long) i * stride);
+                uint32_t *word = A2Span_at(&original, i);
 
-        (void) array2;
+                unbitpackWord(*word, &(currBlock->a), &(currBlock->b),
+                              &(currBlock->c), &(currBlock->d),
+                              &(currBlock->avgPb), &(currBlock->avgPr));
+        }
 }
 
 /*
@@ -277,4 +293,33 @@ void unbitpackWord(uint32_t word, unsigned *a, int *b, int *c, int *d,
         *d = Bitpack_gets(word, D_WIDTH, d_lsb);
         *avgPb = Bitpack_getu(word, CHORMA_WIDTH, avgPb_lsb);
         *avgPr = Bitpack_getu(word, CHORMA_WIDTH, avgPr_lsb);
+}
+
+/*
+ * Name:       unbitpackMean
+ * Purpose:    Gets only the fields of a 32-bit word that describe the mean
+ *             color of its block: a and the two chroma indices
+ * Parameters: uint32_t word: 32-bit unsigned word containing packed data
+ *             unsigned *a: pointer to 9-bit unsigned a value representing
+ *             the quantized mean luma
+ *             unsigned *avgPb: pointer to 4-bit unsigned avgPb index
+ *             unsigned *avgPr: pointer to 4-bit unsigned avgPr index
+ * Return:     None
+ * Expects:    a, avgPb, and avgPr to not be NULL
+ * Notes:      will CRE if a, avgPb, or avgPr is NULL
+ *             b, c, and d are skipped
+ */
+void unbitpackMean(uint32_t word, unsigned *a, unsigned *avgPb,
+                   unsigned *avgPr)
+{
+        assert(a != NULL && avgPb != NULL && avgPr != NULL);
+
+        unsigned a_lsb = 32 - A_WIDTH;
+        unsigned avgPb_lsb = a_lsb - B_WIDTH - C_WIDTH - D_WIDTH -
+                             CHORMA_WIDTH;
+        unsigned avgPr_lsb = avgPb_lsb - CHORMA_WIDTH;
+
+        *a = Bitpack_getu(word, A_WIDTH, a_lsb);
+        *avgPb = Bitpack_getu(word, CHORMA_WIDTH, avgPb_lsb);
+        *avgPr = Bitpack_getu(word, CHORMA_WIDTH, avgPr_lsb);
 }
\ No newline at end of file
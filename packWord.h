@@ -22,21 +22,23 @@
 #include <stdint.h>
 
 A2Methods_UArray2 packWord(A2Methods_UArray2 original,
-                           const struct A2Methods_T *methods);
+                           const struct A2Methods_T *methods, int threads);
 
-void packWordApply(int col, int row, A2Methods_UArray2 array2, void *elem,
-                   void *cl);
+void packWordSpan(int col, int row, int count, A2Methods_Object *base,
+                  int stride, void *cl);
 
 uint32_t bitpackWord(unsigned a, int b, int c, int d, unsigned avgPb,
                      unsigned avgPr);
 
 A2Methods_UArray2 unpackWord(A2Methods_UArray2 original,
-                             const struct A2Methods_T *methods);
+                             const struct A2Methods_T *methods, int threads);
 
-void unpackWordApply(int col, int row, A2Methods_UArray2 array2, void *elem,
-                     void *cl);
+void unpackWordSpan(int col, int row, int count, A2Methods_Object *base,
+                    int stride, void *cl);
 
 void unbitpackWord(uint32_t word, unsigned *a, int *b, int *c, int *d,
                    unsigned *avgPb, unsigned *avgPr);
+void unbitpackMean(uint32_t word, unsigned *a, unsigned *avgPb,
+                   unsigned *avgPr);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,172 @@
+/**************************************************************
+ *                     parallel.c
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the implementation for runParallel(), which
+ *     starts a pool of pthreads that share a list of numbered tasks.
+ *     Each thread takes the next task that has not been started yet
+ *     until none are left, so threads that finish early keep working.
+ *     A task that fails records its exception with failTask(); no more
+ *     tasks are started, and runParallel() raises the exception after
+ *     joining the pool.
+ *
+ **************************************************************/
+#include "parallel.h"
+#include "assert.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+/*
+ * Name:       Task_list
+ * Purpose:    Stores the tasks shared by every thread in the pool
+ * Components: 
+ *             Parallel_taskfun *work: the function that runs one task
+ *             void *cl: the closure passed to every call of work
+ *             int tasks: the number of tasks
+ *             int next: the number of the next task no thread has taken;
+ *             only changed with atomic operations
+ *             int failed: 1 once a task has failed; only changed with
+ *             atomic operations
+ *             const Except_T *failure: the exception of the first task that
+ *             failed, written only by the thread that set failed
+ *             const char *file, int line: where failure was raised
+ */
+struct Task_list {
+        Parallel_taskfun *work;
+        void *cl;
+        int tasks;
+        int next;
+        int failed;
+        const Except_T *failure;
+        const char *file;
+        int line;
+};
+
+/* the tasks the current thread is running, or NULL outside runParallel() */
+static __thread struct Task_list *running;
+
+static void *runTasks(void *cl);
+
+/*
+ * Name:       runParallel
+ * Purpose:    Runs tasks numbered 0 to tasks - 1 on a pool of threads and
+ *             returns once all of them are done
+ * Parameters: int threads: the number of threads to run the tasks on,
+ *             counting the calling thread
+ *             int tasks: the number of tasks to run
+ *             Parallel_taskfun *work: the function called once for each
+ *             task with the task number and cl
+ *             void *cl: a closure passed to every call of work
+ * Return:     None
+ * Expects:    threads to be at least 1 and work to not be NULL
+ *             different tasks to not write to the same memory
+ * Notes:      will CRE if threads is less than 1, work is NULL, or a
+ *             thread cannot be joined
+ *             never starts more threads than there are tasks, and runs
+ *             everything on the calling thread if threads is 1 (or if no
+ *             other thread can be started)
+ *             If a task calls failTask(), the exception it gave is raised
+ *             here, after every thread has stopped, so the closure is never
+ *             in use when the caller unwinds. Tasks not yet started when a
+ *             task fails are skipped.
+ */
+void runParallel(int threads, int tasks, Parallel_taskfun *work, void *cl)
+{
+        assert(threads >= 1 && work != NULL);
+        if (tasks <= 0) {
+                return;
+        }
+        if (threads > tasks) {
+                threads = tasks;
+        }
+
+        struct Task_list list = {
+                .work = work, .cl = cl, .tasks = tasks, .next = 0,
+                .failed = 0, .failure = NULL, .file = NULL, .line = 0
+        };
+
+        pthread_t *pool = malloc(threads * sizeof(pthread_t));
+        assert(pool != NULL);
+
+        int started = 1;
+        while (started < threads &&
+               pthread_create(&pool[started], NULL, runTasks, &list) == 0) {
+                started++;
+        }
+
+        runTasks(&list);
+
+        for (int i = 1; i < started; i++) {
+                int joined = pthread_join(pool[i], NULL);
+                assert(joined == 0);
+        }
+
+        free(pool);
+        if (list.failed) {
+                Except_raise(list.failure, list.file, list.line);
+        }
+}
+
+/*
+ * Name:       failTask
+ * Purpose:    Reports that the task being run failed with an exception
+ * Parameters: const Except_T *e: the exception to raise
+ *             const char *file, int line: where it was raised
+ * Return:     None, when called from a task
+ * Expects:    e to not be NULL
+ *             the task to return as soon as this returns
+ * Notes:      will CRE if e is NULL
+ *             Only the first failure of a runParallel() call is kept; it is
+ *             raised by runParallel() once every thread has stopped. When
+ *             not called from a task, raises e right away, so code run both
+ *             ways can use TASK_RAISE().
+ */
+void failTask(const Except_T *e, const char *file, int line)
+{
+        assert(e != NULL);
+        struct Task_list *list = running;
+        if (list == NULL) {
+                Except_raise(e, file, line);
+                return;
+        }
+
+        if (__atomic_exchange_n(&list->failed, 1, __ATOMIC_ACQ_REL) == 0) {
+                list->failure = e;
+                list->file = file;
+                list->line = line;
+        }
+}
+
+/*
+ * Name:       runTasks
+ * Purpose:    a private function run by every thread in the pool. Takes
+ *             tasks from the shared list and runs them until none are left
+ *             or one has failed
+ * Parameters: void *cl: a pointer to the shared Task_list
+ * Return:     NULL
+ * Expects:    cl to not be NULL
+ * Notes:      sets running for failTask() while it runs, and puts back the
+ *             list of an enclosing runParallel() on the same thread
+ */
+static void *runTasks(void *cl)
+{
+        struct Task_list *list = cl;
+        struct Task_list *outer = running;
+        running = list;
+        int task = __atomic_fetch_add(&list->next, 1, __ATOMIC_RELAXED);
+
+        while (task < list->tasks &&
+               !__atomic_load_n(&list->failed, __ATOMIC_ACQUIRE)) {
+                list->work(task, list->cl);
+                task = __atomic_fetch_add(&list->next, 1, __ATOMIC_RELAXED);
+        }
+
+        running = outer;
+        return NULL;
+}
@@ -0,0 +1,34 @@
+/**************************************************************
+ *                     parallel.h
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the function declarations for parallel.c.
+ *     These functions run a number of independent tasks on a pool of
+ *     threads and wait for all of them to finish.
+ *
+ *     Hanson's exception stack is shared by every thread, so a task must
+ *     not raise an exception itself. It reports the failure with
+ *     TASK_RAISE() and returns instead, and runParallel() raises the
+ *     exception on the thread that called it once every thread has
+ *     stopped.
+ *
+ **************************************************************/
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "except.h"
+
+typedef void Parallel_taskfun(int task, void *cl);
+
+void runParallel(int threads, int tasks, Parallel_taskfun *work, void *cl);
+void failTask(const Except_T *e, const char *file, int line);
+
+#define TASK_RAISE(e) failTask(&(e), __FILE__, __LINE__)
+
+#endif
@@ -0,0 +1,361 @@
+/**************************************************************
+ *                     ppmStream.c
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the implementations for the functions declared
+ *     in ppmStream.h. They parse the header of a raw (P6) or plain (P3)
+ *     PPM and then read its pixels one row at a time into Pnm_rgb structs,
+ *     and print rows of Pnm_rgb structs back out as a raw PPM.
+ *
+ **************************************************************/
+#include "ppmStream.h"
+#include "a2extended.h"
+#include "assert.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+
+/* bytes per fread() or fwrite() of pixels; big enough that stdio passes
+   each write straight to the kernel instead of copying it, and a #define
+   so the buffers it sizes are arrays of fixed size, not VLAs */
+#define ROW_CHUNK (64 * 1024)
+
+static unsigned readHeaderNumber(FILE *input);
+
+/*
+ * Name:       readPPMHeader
+ * Purpose:    Reads the header of a raw (P6) or plain (P3) PPM
+ * Parameters: FILE *input: A pointer to an open file stream beginning at the
+ *             start of a PPM
+ *             unsigned *width: where the width of the image is stored
+ *             unsigned *height: where the height of the image is stored
+ *             unsigned *denominator: where the maximum color value of the
+ *             image is stored
+ * Return:     PPM_RAW for a P6 PPM or PPM_PLAIN for a P3 PPM
+ * Expects:    input, width, height, and denominator to not be NULL
+ * Notes:      will CRE if any pointer is NULL
+ *             raises Pnm_Badformat if the input is not a P6 or P3 PPM or if
+ *             the maximum color value is not between 1 and 65535
+ *             leaves input at the first byte of the first pixel
+ */
+enum PPM_format readPPMHeader(FILE *input, unsigned *width, unsigned *height,
+                              unsigned *denominator)
+{
+        assert(input != NULL && width != NULL && height != NULL &&
+               denominator != NULL);
+
+        if (getc(input) != 'P') {
+                RAISE(Pnm_Badformat);
+        }
+        int magic = getc(input);
+        if (magic != '6' && magic != '3') {
+                RAISE(Pnm_Badformat);
+        }
+
+        *width = readHeaderNumber(input);
+        *height = readHeaderNumber(input);
+        *denominator = readHeaderNumber(input);
+
+        if (*denominator == 0 || *denominator > 65535) {
+                RAISE(Pnm_Badformat);
+        }
+
+        return magic == '6' ? PPM_RAW : PPM_PLAIN;
+}
+
+/*
+ * Name:       readPPMRow
+ * Purpose:    Reads one row of pixels from a raw (P6) PPM
+ * Parameters: struct Input_source *input: the source positioned at the
+ *             start of a row of pixels
+ *             unsigned width: the number of pixels in a row
+ *             unsigned storedWidth: the number of pixels at the start of
+ *             the row to store; the rest are read and dropped
+ *             unsigned denominator: the maximum color value of the image,
+ *             which decides whether samples are one or two bytes
+ *             Pnm_rgb row: an array of storedWidth Pnm_rgb structs where
+ *             the pixels are stored
+ * Return:     None
+ * Expects:    input and row to not be NULL and storedWidth to be at most
+ *             width
+ * Notes:      will CRE if input or row is NULL
+ *             raises Pnm_Badformat if the input ends in the middle of a row
+ *             or a stored sample is larger than denominator, since the
+ *             color tables only go up to denominator
+ *             reads the row in chunks of at most ROW_CHUNK bytes, which
+ *             come straight from the mapping when input is mapped
+ */
+void readPPMRow(struct Input_source *input, unsigned width,
+                unsigned storedWidth, unsigned denominator, Pnm_rgb row)
+{
+        assert(input != NULL && row != NULL && storedWidth <= width);
+        unsigned sampleBytes = denominator > 255 ? 2 : 1;
+        unsigned pixelBytes = 3 * sampleBytes;
+        unsigned pixelsPerChunk = ROW_CHUNK / pixelBytes;
+        unsigned char bytes[ROW_CHUNK];
+
+        for (unsigned first = 0; first < width; first += pixelsPerChunk) {
+                unsigned count = width - first;
+                if (count > pixelsPerChunk) {
+                        count = pixelsPerChunk;
+                }
+                const unsigned char *sample =
+                        readInputBytes(input, bytes, count * pixelBytes);
+                if (sample == NULL) {
+                        RAISE(Pnm_Badformat);
+                }
+
+                unsigned last = first + count < storedWidth ? first + count
+                                                            : storedWidth;
+                unsigned largest = 0;
+                for (unsigned col = first; col < last; col++) {
+                        unsigned rgb[3];
+                        for (int i = 0; i < 3; i++) {
+                                rgb[i] = sample[0];
+                                if (sampleBytes == 2) {
+                                        rgb[i] = rgb[i] << 8 | sample[1];
+                                }
+                                largest = rgb[i] > largest ? rgb[i]
+                                                           : largest;
+                                sample += sampleBytes;
+                        }
+                        row[col].red = rgb[0];
+                        row[col].green = rgb[1];
+                        row[col].blue = rgb[2];
+                }
+                if (largest > denominator) {
+                        RAISE(Pnm_Badformat);
+                }
+        }
+}
+
+/*
+ * Name:       readPlainPPMRow
+ * Purpose:    Reads one row of pixels from a plain (P3) PPM
+ * Parameters: FILE *input: A pointer to an open file stream positioned at
+ *             the start of a row of pixels
+ *             unsigned width: the number of pixels in a row
+ *             unsigned storedWidth: the number of pixels at the start of
+ *             the row to store; the rest are read and dropped
+ *             unsigned denominator: the maximum color value of the image
+ *             Pnm_rgb row: an array of storedWidth Pnm_rgb structs where
+ *             the pixels are stored
+ * Return:     None
+ * Expects:    input and row to not be NULL and storedWidth to be at most
+ *             width
+ * Notes:      will CRE if input or row is NULL
+ *             raises Pnm_Badformat if a sample is missing or larger than
+ *             denominator
+ */
+void readPlainPPMRow(FILE *input, unsigned width, unsigned storedWidth,
+                     unsigned denominator, Pnm_rgb row)
+{
+        assert(input != NULL && row != NULL && storedWidth <= width);
+
+        for (unsigned col = 0; col < width; col++) {
+                unsigned red = readHeaderNumber(input);
+                unsigned green = readHeaderNumber(input);
+                unsigned blue = readHeaderNumber(input);
+                if (red > denominator || green > denominator ||
+                    blue > denominator) {
+                        RAISE(Pnm_Badformat);
+                }
+                if (col < storedWidth) {
+                        row[col].red = red;
+                        row[col].green = green;
+                        row[col].blue = blue;
+                }
+        }
+}
+
+/*
+ * Name:       printPPMHeader
+ * Purpose:    Prints the header of a raw (P6) PPM, in the same form
+ *             Pnm_ppmwrite() uses
+ * Parameters: FILE *output: A pointer to an open file stream
+ *             unsigned width: the width of the image
+ *             unsigned height: the height of the image
+ *             unsigned denominator: the maximum color value of the image
+ * Return:     None
+ * Expects:    output to not be NULL
+ * Notes:      will CRE if output is NULL
+ */
+void printPPMHeader(FILE *output, unsigned width, unsigned height,
+                    unsigned denominator)
+{
+        assert(output != NULL);
+        char header[64];
+        formatPPMHeader(header, sizeof(header), width, height, denominator);
+        fputs(header, output);
+}
+
+/*
+ * Name:       formatPPMHeader
+ * Purpose:    Stores the header of a raw (P6) PPM in a string
+ * Parameters: char *buffer: where the header is stored, with a '\0' after
+ *             size_t size: the number of bytes buffer has room for
+ *             unsigned width: the width of the image
+ *             unsigned height: the height of the image
+ *             unsigned denominator: the maximum color value of the image
+ * Return:     the length of the header in bytes, not counting the '\0'
+ * Expects:    buffer to not be NULL; 64 bytes are always enough
+ * Notes:      will CRE if buffer is NULL or too small
+ *             the same bytes printPPMHeader() prints
+ */
+size_t formatPPMHeader(char *buffer, size_t size, unsigned width,
+                       unsigned height, unsigned denominator)
+{
+        assert(buffer != NULL);
+        int length = snprintf(buffer, size, "P6\n%u %u\n%u\n", width, height,
+                              denominator);
+        assert(length >= 0 && (size_t) length < size);
+        return length;
+}
+
+/*
+ * Name:       printPPMRow
+ * Purpose:    Prints one row of pixels of a raw (P6) PPM
+ * Parameters: FILE *output: A pointer to an open file stream
+ *             unsigned width: the number of pixels in the row
+ *             unsigned denominator: the maximum color value of the image,
+ *             which decides whether samples are one or two bytes
+ *             Pnm_rgb row: an array of width pixels to print
+ * Return:     None
+ * Expects:    output and row to not be NULL and every sample to be at most
+ *             denominator
+ * Notes:      will CRE if output or row is NULL or if the write fails
+ *             packs the row into chunks of at most ROW_CHUNK bytes, so
+ *             there is one fwrite() per chunk instead of one per byte
+ */
+void printPPMRow(FILE *output, unsigned width, unsigned denominator,
+                 Pnm_rgb row)
+{
+        assert(output != NULL && row != NULL);
+        unsigned sampleBytes = denominator > 255 ? 2 : 1;
+        unsigned pixelBytes = 3 * sampleBytes;
+        unsigned pixelsPerChunk = ROW_CHUNK / pixelBytes;
+        unsigned char bytes[ROW_CHUNK];
+
+        for (unsigned first = 0; first < width; first += pixelsPerChunk) {
+                unsigned count = width - first;
+                if (count > pixelsPerChunk) {
+                        count = pixelsPerChunk;
+                }
+
+                unsigned char *sample = bytes;
+                for (unsigned col = first; col < first + count; col++) {
+                        unsigned rgb[3] = { row[col].red, row[col].green,
+                                            row[col].blue };
+                        for (int i = 0; i < 3; i++) {
+                                if (sampleBytes == 2) {
+                                        *sample++ = rgb[i] >> 8;
+                                }
+                                *sample++ = rgb[i];
+                        }
+                }
+
+                size_t written = fwrite(bytes, pixelBytes, count, output);
+                assert(written == count);
+        }
+}
+
+/*
+ * Name:       printPPM
+ * Purpose:    Prints a whole image as a raw (P6) PPM
+ * Parameters: FILE *output: A pointer to an open file stream
+ *             Pnm_ppm image: the image to print, whose pixels must use one
+ *             of our extended method suites
+ * Return:     None
+ * Expects:    output and image to not be NULL and every sample to be at
+ *             most image->denominator
+ * Notes:      will CRE if output or image is NULL or if a write fails
+ *             Prints the same bytes as Pnm_ppmwrite(), one row at a time
+ *             with printPPMRow(). Rows stored contiguously are printed in
+ *             place; others are copied into a temporary row first.
+ */
+void printPPM(FILE *output, Pnm_ppm image)
+{
+        assert(output != NULL && image != NULL);
+        printPPMHeader(output, image->width, image->height,
+                       image->denominator);
+        if (image->width == 0) {
+                return;
+        }
+
+        Pnm_rgb rowCopy = malloc(image->width * sizeof(struct Pnm_rgb));
+        assert(rowCopy != NULL);
+
+        for (unsigned row = 0; row < image->height; row++) {
+                struct A2Span span = A2Span_new(image->methods, image->pixels,
+                                                0, row, image->width);
+                Pnm_rgb pixels = rowCopy;
+                if (span.base != NULL &&
+                    span.stride == sizeof(struct Pnm_rgb)) {
+                        pixels = (Pnm_rgb) span.base;
+                } else {
+                        for (unsigned col = 0; col < image->width; col++) {
+                                rowCopy[col] = *(Pnm_rgb) A2Span_at(&span,
+                                                                    col);
+                        }
+                }
+
+                printPPMRow(output, image->width, image->denominator,
+                            pixels);
+        }
+
+        free(rowCopy);
+}
+
+/*
+ * Name:       readHeaderNumber
+ * Purpose:    a private function that reads one unsigned decimal number from
+ *             a PPM header (or a sample of a plain PPM), skipping the
+ *             whitespace and comments before it
+ * Parameters: FILE *input: A pointer to an open file stream inside a PPM
+ *             header
+ * Return:     the number that was read
+ * Expects:    input to not be NULL
+ * Notes:      raises Pnm_Badformat if no number is found or if the number
+ *             does not fit in an unsigned
+ *             consumes the single whitespace character after the number,
+ *             which is what the format requires after the maximum value.
+ *             The last sample of a plain PPM may be followed by EOF instead.
+ */
+static unsigned readHeaderNumber(FILE *input)
+{
+        int c = getc(input);
+        while (c == '#' || c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+                if (c == '#') {
+                        while (c != '\n' && c != EOF) {
+                                c = getc(input);
+                        }
+                }
+                c = getc(input);
+        }
+
+        if (c < '0' || c > '9') {
+                RAISE(Pnm_Badformat);
+        }
+
+        unsigned number = 0;
+        while (c >= '0' && c <= '9') {
+                unsigned digit = c - '0';
+                if (number > (UINT_MAX - digit) / 10) {
+                        RAISE(Pnm_Badformat);
+                }
+                number = number * 10 + digit;
+                c = getc(input);
+        }
+
+        if (c != EOF && c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+                RAISE(Pnm_Badformat);
+        }
+
+        return number;
+}
@@ -0,0 +1,42 @@
+/**************************************************************
+ *                     ppmStream.h
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the function declarations for ppmStream.c.
+ *     These functions read a raw (P6) or plain (P3) PPM and write a raw
+ *     PPM one row at a time, so an image can be compressed or decompressed
+ *     without ever holding all of it in memory. readInPPM() uses them to
+ *     read a whole image.
+ *
+ **************************************************************/
+#ifndef PPM_STREAM_H
+#define PPM_STREAM_H
+
+#include <stdio.h>
+#include "pnm.h"
+#include "inputSource.h"
+
+enum PPM_format { PPM_RAW, PPM_PLAIN };
+
+enum PPM_format readPPMHeader(FILE *input, unsigned *width, unsigned *height,
+                              unsigned *denominator);
+void readPPMRow(struct Input_source *input, unsigned width,
+                unsigned storedWidth, unsigned denominator, Pnm_rgb row);
+void readPlainPPMRow(FILE *input, unsigned width, unsigned storedWidth,
+                     unsigned denominator, Pnm_rgb row);
+
+void printPPMHeader(FILE *output, unsigned width, unsigned height,
+                    unsigned denominator);
+size_t formatPPMHeader(char *buffer, size_t size, unsigned width,
+                       unsigned height, unsigned denominator);
+void printPPMRow(FILE *output, unsigned width, unsigned denominator,
+                 Pnm_rgb row);
+void printPPM(FILE *output, Pnm_ppm image);
+
+#endif
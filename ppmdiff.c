@@ -67,7 +67,7 @@ int main(int argc, char *argv[])
                 return EXIT_FAILURE;
         }
 
-        float numerator;
+        float numerator = 0;
         int h = fmin(image1->height, image2->height);
         int w = fmin(image1->width, image2->width);
 
@@ -14,6 +14,7 @@
  *
  **************************************************************/
 #include "quantize.h"
+#include "a2extended.h"
 #include "assert.h"
 #include <stdlib.h>
 #include <math.h>
@@ -37,6 +38,8 @@ static float clamp(float value, float min, float max);
  *        into blocks.
  *        const struct A2Methods_T *methods: A pointer to a A2Methods_T struct
  *        that contains pointers to functions on can use on a UArray2
+ *        int threads: the number of threads to run the stage on,
+ *        counting the calling thread
  *
  * Return: a pointer to a newly allocated A2Methods_UArray2 struct storing
  *         Quantized_Block structs representing the pixels from the original
@@ -53,7 +56,7 @@ static float clamp(float value, float min, float max);
  *
  ************************************************************/
 A2Methods_UArray2 quantizeData(A2Methods_UArray2 original,
-                               const struct A2Methods_T *methods)
+                               const struct A2Methods_T *methods, int threads)
 {
         assert(original != NULL && methods != NULL);
         A2Methods_UArray2 destination = methods->new(
@@ -62,60 +65,85 @@ A2Methods_UArray2 quantizeData(A2Methods_UArray2 original,
 
         struct Closure cl = { .array = destination, .methods = methods };
 
-        methods->map_default(original, quantizeApply, &cl);
+        A2Extended(methods)->map_spans_parallel(original, threads,
+                                                quantizeSpan, &cl);
 
         return destination;
 }
 
 /*
- * Name:       quantizeApply
+ * Name:       quantizeSpan
  * Purpose:    Quantize each 2x2 block of the image by converting its cosine 
  *             coefficients and averaged chroma values into integers
- * Parameters: int col: an integer representing the distance between the
- *             current element and the left edge of the array
- *             int row: an integer representing the distance between the
- *             current element and the top of the array
- *             A2Methods_UArray2 array2: required by the A2Methods_Object
- *             interface; ignored here
- *             A2Methods_Object *elem: a pointer to a YPbPr_block representing 
- *             the current 2x2 block of the image
+ * Parameters: int col: the column of the first element of the span
+ *             int row: the row of the span
+ *             int count: the number of elements in the span
+ *             A2Methods_Object *base: a pointer to the first YPbPr_block of
+ *             the span, each representing a 2x2 block of the image
+ *             int stride: the number of bytes from one element of
+ *             the span to the next
  *             void *cl: a pointer to a Closure struct containing a pointer
  *             to a A2Methods_UArray2 (the destination image in YPbPr_pixel
  *             format) and a pointer to an A2Methods_T struct with function
  *             pointers for operating on the array.
  * Return:     None
- * Expects:    elem to not be NULL and cl points to a Closure struct that
+ * Expects:    base to not be NULL and cl points to a Closure struct that
  *             stores a non-NULL A2Methods_UArray2 and A2Methods_T struct 
  *             and is not NULL
- *             col and row are within the bounds of the array
+ *             the span is within the bounds of the array
  * Notes:      will CRE if cl is NULL or its array or methods field is NULL
- *             will CRE if elem is NULL
- *             If col or row are out of bounds or not used by the array,
- *             the methods->at function will throw a CRE
+ *             will CRE if base is NULL
+ *             If the span is out of bounds, A2Span_new will throw
+ *             a CRE
  */
-void quantizeApply(int col, int row, A2Methods_UArray2 array2,
-                   A2Methods_Object *elem, void *cl)
+void quantizeSpan(int col, int row, int count, A2Methods_Object *base,
+                  int stride, void *cl)
 {
-        assert(elem != NULL && cl != NULL);
+        assert(base != NULL && cl != NULL);
         struct Closure *closure = cl;
         assert(closure != NULL && closure->methods != NULL &&
                closure->array != NULL);
-        struct YPbPr_block *currBlock = elem;
 
-        struct Quantized_Block *quantized =
-                closure->methods->at(closure->array, col, row);
+        struct A2Span destination = A2Span_new(closure->methods,
+                                               closure->array, col, row,
+                                               count);
+        char *blocks = base;
 
-        quantized->a = linearQuantizeValue(currBlock->a, A_WIDTH, 1);
-        quantized->b = linearQuantizeValue(clamp(currBlock->b, -0.3, 0.3),
+        for (int i = 0; i < count; i++) {
+                struct YPbPr_block *currBlock =
+                        (struct YPbPr_block *) (blocks + (long) i * stride);
+
+                quantizeBlock(currBlock, A2Span_at(&destination, i));
+        }
+}
+
+/*
+ * Name:       quantizeBlock
+ * Purpose:    Quantizes the cosine coefficients and averaged chroma values
+ *             of a single 2x2 block into integers
+ * Parameters: const struct YPbPr_block *block: a pointer to the block of
+ *             coefficients to quantize
+ *             struct Quantized_Block *quantized: a pointer to the
+ *             Quantized_Block where the quantized values will be stored
+ * Return:     None
+ * Expects:    block and quantized to not be NULL
+ * Notes:      will CRE if block or quantized is NULL
+ *             b, c, and d are clamped to [-0.3, 0.3] before quantizing
+ */
+void quantizeBlock(const struct YPbPr_block *block,
+                   struct Quantized_Block *quantized)
+{
+        assert(block != NULL && quantized != NULL);
+
+        quantized->a = linearQuantizeValue(block->a, A_WIDTH, 1);
+        quantized->b = linearQuantizeValue(clamp(block->b, -0.3, 0.3),
                                            B_WIDTH - 1, 0.3);
-        quantized->c = linearQuantizeValue(clamp(currBlock->c, -0.3, 0.3),
+        quantized->c = linearQuantizeValue(clamp(block->c, -0.3, 0.3),
                                            C_WIDTH - 1, 0.3);
-        quantized->d = linearQuantizeValue(clamp(currBlock->d, -0.3, 0.3),
+        quantized->d = linearQuantizeValue(clamp(block->d, -0.3, 0.3),
                                            D_WIDTH - 1, 0.3);
-        quantized->avgPb = Arith40_index_of_chroma(currBlock->avgPb);
-        quantized->avgPr = Arith40_index_of_chroma(currBlock->avgPr);
-
-        (void) array2;
+        quantized->avgPb = Arith40_index_of_chroma(block->avgPb);
+        quantized->avgPr = Arith40_index_of_chroma(block->avgPr);
 }
 
 /*
@@ -146,6 +174,8 @@ int linearQuantizeValue(float value, int width, float maxFloat)
  *        into blocks and quantized.
  *        const struct A2Methods_T *methods: A pointer to a A2Methods_T struct
  *        that contains pointers to functions on can use on a UArray2
+ *        int threads: the number of threads to run the stage on,
+ *        counting the calling thread
  *
  * Return: a pointer to a newly allocated A2Methods_UArray2 struct storing
  *         YPbPr_block structs representing the dequantized DCT coefficients
@@ -162,7 +192,7 @@ int linearQuantizeValue(float value, int width, float maxFloat)
  *
  ************************************************************/
 A2Methods_UArray2 dequantizeData(A2Methods_UArray2 original,
-                                 const struct A2Methods_T *methods)
+                                 const struct A2Methods_T *methods, int threads)
 {
         assert(original != NULL && methods != NULL);
         A2Methods_UArray2 destination = methods->new(
@@ -171,58 +201,107 @@ A2Methods_UArray2 dequantizeData(A2Methods_UArray2 original,
 
         struct Closure cl = { .array = destination, .methods = methods };
 
-        methods->map_default(original, dequantizeApply, &cl);
+        A2Extended(methods)->map_spans_parallel(original, threads,
+                                                dequantizeSpan, &cl);
 
         return destination;
 }
 
 /*
- * Name:       dequantizeApply
+ * Name:       dequantizeSpan
  * Purpose:    Dequantize each 2x2 block of the image by converting its integer 
  *             quantized coefficients and chromas back into floating-point 
  *             values in component video color space.
- * Parameters: int col: an integer representing the distance between the
- *             current element and the left edge of the array
- *             int row: an integer representing the distance between the
- *             current element and the top of the array
- *             A2Methods_UArray2 array2: required by the A2Methods_Object
- *             interface; ignored here
- *             A2Methods_Object *elem: a pointer to a Quantized_Block 
- *             representing the current 2x2 block of the image
+ * Parameters: int col: the column of the first element of the span
+ *             int row: the row of the span
+ *             int count: the number of elements in the span
+ *             A2Methods_Object *base: a pointer to the first Quantized_Block
+ *             of the span, each representing a 2x2 block of the image
+ *             int stride: the number of bytes from one element of
+ *             the span to the next
  *             void *cl: a pointer to a Closure struct containing a pointer
  *             to a A2Methods_UArray2 (the destination image in YPbPr_pixel
  *             format) and a pointer to an A2Methods_T struct with function
  *             pointers for operating on the array.
  * Return:     None
- * Expects:    elem to not be NULL and cl points to a Closure struct that
+ * Expects:    base to not be NULL and cl points to a Closure struct that
  *             stores a non-NULL A2Methods_UArray2 and A2Methods_T struct 
  *             and is not NULL
- *             col and row are within the bounds of the array
+ *             the span is within the bounds of the array
  * Notes:      will CRE if cl is NULL or its array or methods field is NULL
- *             will CRE if elem is NULL
- *             If col or row are out of bounds or not used by the array,
- *             the methods->at function will throw a CRE
+ *             will CRE if base is NULL
+ *             If the span is out of bounds, A2Span_new will throw
+ *             a CRE
  */
-void dequantizeApply(int col, int row, A2Methods_UArray2 array2,
-                     A2Methods_Object *elem, void *cl)
+void dequantizeSpan(int col, int row, int count, A2Methods_Object *base,
+                    int stride, void *cl)
 {
-        assert(elem != NULL && cl != NULL);
+        assert(base != NULL && cl != NULL);
         struct Closure *closure = cl;
         assert(closure != NULL && closure->methods != NULL &&
                closure->array != NULL);
 
-        struct Quantized_Block *quantized = elem;
-        struct YPbPr_block *currBlock =
-                closure->methods->at(closure->array, col, row);
+        struct A2Span destination = A2Span_new(closure->methods,
+                                               closure->array, col, row,
+                                               count);
+        char *quantized = base;
 
-        currBlock->a = linearDequantizeValue(quantized->a, A_WIDTH, 1);
-        currBlock->b = linearDequantizeValue(quantized->b, B_WIDTH - 1, 0.3);
-        currBlock->c = linearDequantizeValue(quantized->c, C_WIDTH - 1, 0.3);
-        currBlock->d = linearDequantizeValue(quantized->d, D_WIDTH - 1, 0.3);
-        currBlock->avgPb = Arith40_chroma_of_index(quantized->avgPb);
-        currBlock->avgPr = Arith40_chroma_of_index(quantized->avgPr);
+        for (int i = 0; i < count; i++) {
+                struct Quantized_Block *currBlock =
+                        (struct Quantized_Block *) (quantized +
+                                                    (long) i * stride);
+
+                dequantizeBlock(currBlock, A2Span_at(&destination, i));
+        }
+}
+
+/*
+ * Name:       dequantizeBlock
+ * Purpose:    Converts the quantized coefficients and chroma indices of a
+ *             single 2x2 block back into floating-point values
+ * Parameters: const struct Quantized_Block *quantized: a pointer to the
+ *             quantized block
+ *             struct YPbPr_block *block: a pointer to the YPbPr_block where
+ *             the dequantized values will be stored
+ * Return:     None
+ * Expects:    quantized and block to not be NULL
+ * Notes:      will CRE if quantized or block is NULL
+ */
+void dequantizeBlock(const struct Quantized_Block *quantized,
+                     struct YPbPr_block *block)
+{
+        assert(quantized != NULL && block != NULL);
+
+        block->a = linearDequantizeValue(quantized->a, A_WIDTH, 1);
+        block->b = linearDequantizeValue(quantized->b, B_WIDTH - 1, 0.3);
+        block->c = linearDequantizeValue(quantized->c, C_WIDTH - 1, 0.3);
+        block->d = linearDequantizeValue(quantized->d, D_WIDTH - 1, 0.3);
+        block->avgPb = Arith40_chroma_of_index(quantized->avgPb);
+        block->avgPr = Arith40_chroma_of_index(quantized->avgPr);
+}
+
+/*
+ * Name:       dequantizeMean
+ * Purpose:    Converts the quantized mean luma and chroma indices of a
+ *             single 2x2 block back into the block's mean color
+ * Parameters: unsigned a: the quantized a coefficient of the block
+ *             unsigned avgPb: the index of the block's average Pb
+ *             unsigned avgPr: the index of the block's average Pr
+ *             struct YPbPr_pixel *pixel: where the mean color is stored
+ * Return:     None
+ * Expects:    pixel to not be NULL
+ * Notes:      will CRE if pixel is NULL
+ *             a is the mean of the block's four Y values, so this is the
+ *             color the whole block would have without b, c, and d
+ */
+void dequantizeMean(unsigned a, unsigned avgPb, unsigned avgPr,
+                    struct YPbPr_pixel *pixel)
+{
+        assert(pixel != NULL);
 
-        (void) array2;
+        pixel->Y = linearDequantizeValue(a, A_WIDTH, 1);
+        pixel->Pb = Arith40_chroma_of_index(avgPb);
+        pixel->Pr = Arith40_chroma_of_index(avgPr);
 }
 
 /*
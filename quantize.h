@@ -20,16 +20,23 @@
 #include "helpers.h"
 
 A2Methods_UArray2 quantizeData(A2Methods_UArray2 original,
-                               const struct A2Methods_T *methods);
-void quantizeApply(int col, int row, A2Methods_UArray2 array2,
-                   A2Methods_Object *elem, void *cl);
+                               const struct A2Methods_T *methods, int threads);
+void quantizeSpan(int col, int row, int count, A2Methods_Object *base,
+                  int stride, void *cl);
+void quantizeBlock(const struct YPbPr_block *block,
+                   struct Quantized_Block *quantized);
 int linearQuantizeValue(float value, int width, float maxFloat);
 
 A2Methods_UArray2 dequantizeData(A2Methods_UArray2 original,
-                                 const struct A2Methods_T *methods);
+                                 const struct A2Methods_T *methods,
+                                 int threads);
 
-void dequantizeApply(int col, int row, A2Methods_UArray2 array2,
-                     A2Methods_Object *elem, void *cl);
+void dequantizeSpan(int col, int row, int count, A2Methods_Object *base,
+                    int stride, void *cl);
+void dequantizeBlock(const struct Quantized_Block *quantized,
+                     struct YPbPr_block *block);
+void dequantizeMean(unsigned a, unsigned avgPb, unsigned avgPr,
+                    struct YPbPr_pixel *pixel);
 
 float linearDequantizeValue(float value, int width, float maxFloat);
 
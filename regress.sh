@@ -0,0 +1,432 @@
+#!/bin/sh
+#
+#                     regress.sh
+#
+#     Assignment: arith
+#     Authors:  Diana Calderon and Madeline Lei
+#     Usernames: dcalde02, mlei03
+#     Date:     10/21/2025
+#
+#     summary:
+#
+#     Regression tests for 40image, run by "make check". Every way of
+#     compressing or decompressing an image must print the same bytes as
+#     the original stage-by-stage program did, whose outputs are recorded
+#     below as cksum values. Prints one line per failed check and exits
+#     with status 1 if any failed.
+#
+#     The images are flowers.ppm and noise images made by noise() below, so
+#     no test data has to be stored.
+#
+
+LC_ALL=C
+export LC_ALL
+
+IMAGE=${IMAGE:-./40image}
+WORK=$(mktemp -d) || exit 1
+trap 'rm -rf "$WORK"' EXIT
+failures=0
+
+# fail NAME: records that the check NAME failed
+fail()
+{
+        echo "FAIL: $1"
+        failures=$((failures + 1))
+}
+
+# same NAME FILE1 FILE2: checks that two files hold the same bytes
+same()
+{
+        cmp -s "$2" "$3" || fail "$1"
+}
+
+# sum FILE: prints the cksum of FILE without its name
+sum()
+{
+        cksum < "$1" | awk '{ print $1, $2 }'
+}
+
+# noise WIDTH HEIGHT MAXVAL SEED: prints a raw PPM of pseudo-random
+# samples; samples take two bytes when MAXVAL is over 255
+noise()
+{
+        awk -v w="$1" -v h="$2" -v m="$3" -v s="$4" 'BEGIN {
+                printf "P6\n%d %d\n%d\n", w, h, m
+                for (i = 0; i < w * h * 3; i++) {
+                        s = (s * 75 + 74) % 65537
+                        v = (s * 31 + i) % (m + 1)
+                        if (m > 255) {
+                                printf "%c%c", int(v / 256), v % 256
+                        } else {
+                                printf "%c", v
+                        }
+                }
+        }'
+}
+
+# crop FILE WIDTH HEIGHT MAXVAL X Y W H: prints the W by H part, whose
+# top-left pixel is (X, Y), of the image made by noise WIDTH HEIGHT MAXVAL
+crop()
+{
+        bytes=3
+        [ "$4" -gt 255 ] && bytes=6
+        skip=$(printf 'P6\n%d %d\n%d\n' "$2" "$3" "$4" | wc -c)
+        printf 'P6\n%d %d\n%d\n' "$7" "$8" "$4"
+        row=0
+        while [ $row -lt "$8" ]; do
+                tail -c +$((skip + (($6 + row) * $2 + $5) * bytes + 1)) "$1" |
+                        head -c $(($7 * bytes))
+                row=$((row + 1))
+        done
+}
+
+# flipLastByte FILE: changes one bit of the last byte of FILE
+flipLastByte()
+{
+        size=$(wc -c < "$1")
+        byte=$(tail -c 1 "$1" | od -An -tu1 | tr -d ' ')
+        printf "\\$(printf %o $((byte ^ 1)))" |
+                dd of="$1" bs=1 seek=$((size - 1)) conv=notrunc 2> /dev/null
+}
+
+# withinOne KIND REPORT: checks that the --fixed-report output REPORT
+# has a line about KIND ("code words" or "bytes"), and that no field or
+# byte it reports differed from the float engine by more than 1
+withinOne()
+{
+        awk -v kind="$1" '
+                /largest field differences:/ {
+                        words = 1
+                        sub(/.*differences: /, "")
+                        n = split($0, fields, /, /)
+                        for (i = 1; i <= n; i++) {
+                                split(fields[i], pair, " ")
+                                if (pair[2] + 0 > 1) {
+                                        wide = 1
+                                }
+                        }
+                }
+                /bytes differ from float, by at most/ {
+                        bytes = 1
+                        if ($NF + 0 > 1) {
+                                wide = 1
+                        }
+                }
+                END {
+                        seen = kind == "bytes" ? bytes : words
+                        exit !seen || wide
+                }' "$2"
+}
+
+cp flowers.ppm "$WORK/flowers.ppm"
+noise 66 50 255 1 > "$WORK/noise.ppm"
+noise 31 17 100 2 > "$WORK/odd.ppm"
+noise 40 30 1000 3 > "$WORK/deep.ppm"
+noise 20 10 65535 4 > "$WORK/full.ppm"
+
+# the cksums of what the original program printed for each image: the
+# compressed image, and the compressed image decompressed again
+expected()
+{
+        case $1 in
+        flowers) echo "2576054202 18041 2041678697 54015" ;;
+        noise)   echo "3343987549 3339 1737069826 9913" ;;
+        odd)     echo "3274999865 519 585508796 1453" ;;
+        deep)    echo "2449301770 1239 957133729 3613" ;;
+        full)    echo "1625963212 239 868633343 613" ;;
+        esac
+}
+
+# byte identity: every path prints what the original program printed
+for name in flowers noise odd deep full; do
+        ppm="$WORK/$name.ppm"
+        c40="$WORK/$name.c40"
+        out="$WORK/$name.out.ppm"
+        "$IMAGE" -c "$ppm" > "$c40"
+        "$IMAGE" -d "$c40" > "$out"
+        [ "$(sum "$c40") $(sum "$out")" = "$(expected $name)" ] ||
+                fail "$name: output differs from the original program"
+
+        for flags in "--staged" "--stream" "-j 3" "--staged -j 2" \
+                     "--stream -j 2"; do
+                "$IMAGE" -c $flags "$ppm" > "$WORK/x.c40" 2> /dev/null
+                same "$name: -c${flags:+ $flags}" "$WORK/x.c40" "$c40"
+                "$IMAGE" -d $flags "$c40" > "$WORK/x.ppm" 2> /dev/null
+                same "$name: -d${flags:+ $flags}" "$WORK/x.ppm" "$out"
+        done
+        "$IMAGE" -c < "$ppm" > "$WORK/x.c40"
+        same "$name: -c from a pipe" "$WORK/x.c40" "$c40"
+        "$IMAGE" -d < "$c40" > "$WORK/x.ppm"
+        same "$name: -d from a pipe" "$WORK/x.ppm" "$out"
+        "$IMAGE" -c --stream < "$ppm" > "$WORK/x.c40"
+        same "$name: -c --stream from a pipe" "$WORK/x.c40" "$c40"
+        "$IMAGE" -d --stream < "$c40" > "$WORK/x.ppm"
+        same "$name: -d --stream from a pipe" "$WORK/x.ppm" "$out"
+
+        # mapped output files (-o), and outputs that cannot be mapped
+        for flags in "" "-j 3"; do
+                "$IMAGE" -c $flags -o "$WORK/o.c40" "$ppm"
+                same "$name: -c${flags:+ $flags} -o FILE" "$WORK/o.c40" "$c40"
+                "$IMAGE" -d $flags -o "$WORK/o.ppm" "$c40"
+                same "$name: -d${flags:+ $flags} -o FILE" "$WORK/o.ppm" "$out"
+                "$IMAGE" -c $flags -o /dev/stdout "$ppm" | cat > "$WORK/p"
+                same "$name: -c${flags:+ $flags} -o a pipe" "$WORK/p" "$c40"
+                "$IMAGE" -d $flags -o /dev/stdout "$c40" | cat > "$WORK/p"
+                same "$name: -d${flags:+ $flags} -o a pipe" "$WORK/p" "$out"
+                "$IMAGE" -d $flags -o /dev/null "$c40" ||
+                        fail "$name: -d${flags:+ $flags} -o /dev/null"
+        done
+
+        # tiles, with and without checksums, from a file and a pipe
+        for flags in "--tiled" "--tiled -j 3" "--crc" "--crc -j 2"; do
+                "$IMAGE" -c $flags "$ppm" > "$WORK/t.c40"
+                "$IMAGE" -d "$WORK/t.c40" > "$WORK/x.ppm"
+                same "$name: $flags" "$WORK/x.ppm" "$out"
+                "$IMAGE" -d -j 3 < "$WORK/t.c40" > "$WORK/x.ppm"
+                same "$name: $flags from a pipe" "$WORK/x.ppm" "$out"
+        done
+        flipLastByte "$WORK/t.c40"
+        "$IMAGE" -d "$WORK/t.c40" > /dev/null 2>&1 &&
+                fail "$name: a corrupt tile passed its checksum"
+
+        # a region covering the whole image is the whole image
+        "$IMAGE" -d --region 0,0,100000,100000 "$c40" > "$WORK/x.ppm"
+        same "$name: --region of everything" "$WORK/x.ppm" "$out"
+done
+
+# -c --region compresses a view of the image, so it must print what
+# compressing a copy of the crop does. Each test is an image, its size
+# and maxval, the region, and the crop it is cut down to
+for test in "noise 66 50 255 5,3,20,11 5 3 20 10" \
+            "noise 66 50 255 61,41,100,100 61 41 4 8" \
+            "full 20 10 65535 1,1,10,8 1 1 10 8"; do
+        set -- $test
+        crop "$WORK/$1.ppm" $2 $3 $4 $6 $7 $8 $9 > "$WORK/crop.ppm"
+        "$IMAGE" -c "$WORK/crop.ppm" > "$WORK/crop.c40"
+        "$IMAGE" -d "$WORK/crop.c40" > "$WORK/crop.out.ppm"
+        for flags in "" "--staged" "--stream" "-j 3" "--staged -j 2"; do
+                "$IMAGE" -c --region $5 $flags "$WORK/$1.ppm" > "$WORK/x.c40"
+                same "$1: -c --region $5${flags:+ $flags}" "$WORK/x.c40" \
+                        "$WORK/crop.c40"
+        done
+        "$IMAGE" -c --region $5 --tiled "$WORK/$1.ppm" > "$WORK/x.c40"
+        "$IMAGE" -d "$WORK/x.c40" > "$WORK/x.ppm"
+        same "$1: -c --region $5 --tiled" "$WORK/x.ppm" "$WORK/crop.out.ppm"
+        "$IMAGE" -c --region $5 -o "$WORK/o.c40" "$WORK/$1.ppm"
+        same "$1: -c --region $5 -o FILE" "$WORK/o.c40" "$WORK/crop.c40"
+done
+# a crop whose corner is on a block holds the image's own blocks
+"$IMAGE" -c --region 2,4,30,20 "$WORK/flowers.ppm" > "$WORK/x.c40"
+"$IMAGE" -d "$WORK/x.c40" > "$WORK/x.ppm"
+"$IMAGE" -d --region 2,4,30,20 "$WORK/flowers.c40" > "$WORK/y.ppm"
+same "-c --region of blocks" "$WORK/x.ppm" "$WORK/y.ppm"
+
+# the fixed-point engine prints the same bytes on every path; these
+# cksums were recorded when it was added
+for flags in "" "-j 3" "--stream"; do
+        "$IMAGE" -c --fixed $flags "$WORK/flowers.ppm" > "$WORK/f.c40"
+        [ "$(sum "$WORK/f.c40")" = "623782738 18041" ] ||
+                fail "--fixed -c${flags:+ $flags}"
+        "$IMAGE" -d --fixed $flags "$WORK/flowers.c40" > "$WORK/f.ppm"
+        [ "$(sum "$WORK/f.ppm")" = "3174325624 54015" ] ||
+                fail "--fixed -d${flags:+ $flags}"
+done
+# --fixed-report prints what --fixed does, and every field and byte it
+# reports is within 1 of the float engine's
+for name in flowers noise odd deep full; do
+        "$IMAGE" -c --fixed "$WORK/$name.ppm" > "$WORK/f.c40"
+        "$IMAGE" -c --fixed-report "$WORK/$name.ppm" > "$WORK/x.c40" \
+                2> "$WORK/report"
+        same "$name: -c --fixed-report" "$WORK/x.c40" "$WORK/f.c40"
+        withinOne "code words" "$WORK/report" ||
+                fail "$name: -c --fixed-report: > 1"
+        for flags in "" "--preview"; do
+                "$IMAGE" -d --fixed-report $flags "$WORK/$name.c40" \
+                        > /dev/null 2> "$WORK/report"
+                withinOne bytes "$WORK/report" ||
+                        fail "$name: -d --fixed-report${flags:+ $flags}: > 1"
+        done
+done
+
+# -j takes a positive number; one too large to be a thread count is cut
+# down instead of wrapping around to no threads
+for threads in 0 -2 3x "" 99999999999999999999; do
+        "$IMAGE" -c -j "$threads" "$WORK/noise.ppm" > "$WORK/x" 2> /dev/null &&
+                fail "-j '$threads' was taken"
+        [ -s "$WORK/x" ] && fail "-j '$threads' printed"
+done
+for threads in 1073741824 2147483647; do
+        "$IMAGE" -c -j $threads "$WORK/noise.ppm" > "$WORK/x.c40"
+        same "-c -j $threads" "$WORK/x.c40" "$WORK/noise.c40"
+        "$IMAGE" -d -j $threads "$WORK/noise.c40" > "$WORK/x.ppm"
+        same "-d -j $threads" "$WORK/x.ppm" "$WORK/noise.out.ppm"
+done
+
+# a PPM header number too large for an unsigned is a bad format, not
+# wrapped around to a small one; 4294967298 is 2 more than UINT_MAX + 1
+printf 'P6\n4294967298 2\n255\n' > "$WORK/wrap.ppm"
+awk 'BEGIN { for (i = 0; i < 12; i++) printf "%c", i }' >> "$WORK/wrap.ppm"
+printf 'P3\n2 2\n255\n1 2 3 4 5 4294967297 1 2 3 4 5 6\n' > "$WORK/wrap3.ppm"
+for ppm in wrap.ppm wrap3.ppm; do
+        for flags in "" "--stream" "--staged"; do
+                "$IMAGE" -c $flags "$WORK/$ppm" > "$WORK/x" 2> /dev/null &&
+                        fail "-c${flags:+ $flags} took $ppm"
+                [ -s "$WORK/x" ] && fail "-c${flags:+ $flags} printed $ppm"
+        done
+done
+
+# -d --preview prints one pixel per block; this cksum was recorded when
+# it was added
+for flags in "" "-j 3"; do
+        "$IMAGE" -d --preview $flags "$WORK/flowers.c40" > "$WORK/x.ppm"
+        [ "$(sum "$WORK/x.ppm")" = "902817993 13513" ] ||
+                fail "-d --preview${flags:+ $flags}"
+done
+"$IMAGE" -d --preview < "$WORK/flowers.c40" > "$WORK/x.ppm"
+[ "$(sum "$WORK/x.ppm")" = "902817993 13513" ] ||
+        fail "-d --preview from a pipe"
+
+# the CRC32C of each tile in the index; this cksum was recorded when the
+# checksums were added, after checking them with a bitwise CRC32C
+"$IMAGE" -c --crc "$WORK/flowers.ppm" > "$WORK/x.c40"
+[ "$(sum "$WORK/x.c40")" = "797894551 18086" ] || fail "-c --crc"
+
+# format 3 files written by hand from the code words of a 200x4 image
+noise 200 4 255 5 > "$WORK/wide.ppm"
+"$IMAGE" -c "$WORK/wide.ppm" > "$WORK/wide.c40"
+"$IMAGE" -d "$WORK/wide.c40" > "$WORK/wide.out.ppm"
+header="COMP40 Compressed image format 2
+200 4
+"
+# tiled SIZE: the wide image as format 3 with the tile size SIZE (in
+# blocks) and one index entry, offset 0 and size 800 (see tiled.h)
+tiled()
+{
+        printf 'COMP40 Compressed image format 3\n200 4\n%s\n' "$1"
+        printf '\0\0\0\0\0\0\0\0\0\0\3\40'
+        tail -c +$((${#header} + 1)) "$WORK/wide.c40"
+}
+# a format 3 file of odd size is rejected like format 2's
+printf 'COMP40 Compressed image format 3\n201 4\n100 2\n' > "$WORK/odd.t.c40"
+printf '\0\0\0\0\0\0\0\0\0\0\3\40' >> "$WORK/odd.t.c40"
+tail -c +$((${#header} + 1)) "$WORK/wide.c40" >> "$WORK/odd.t.c40"
+for flags in "" "--region 198,0,3,4" "--preview"; do
+        "$IMAGE" -d $flags "$WORK/odd.t.c40" > "$WORK/x" 2> /dev/null &&
+                fail "-d${flags:+ $flags} took a format 3 file of odd size"
+        [ -s "$WORK/x" ] &&
+                fail "-d${flags:+ $flags} printed a format 3 file of odd size"
+done
+# a tile wider than the encoder's 64 blocks: one 100 by 2 block tile
+tiled "100 2" > "$WORK/wide.t.c40"
+"$IMAGE" -d "$WORK/wide.t.c40" > "$WORK/x.ppm" 2> /dev/null
+same "a tile wider than 64 blocks" "$WORK/x.ppm" "$WORK/wide.out.ppm"
+# a tile larger than the image is clamped to it, not multiplied out
+tiled "4000000000 4000000000" > "$WORK/huge.t.c40"
+"$IMAGE" -d "$WORK/huge.t.c40" > "$WORK/x.ppm" 2> /dev/null
+same "a tile larger than the image" "$WORK/x.ppm" "$WORK/wide.out.ppm"
+
+# a format 3 --region or --preview prints what format 2's does
+"$IMAGE" -c --tiled "$WORK/flowers.ppm" > "$WORK/flowers.t.c40"
+for flags in "--preview" "--region 3,5,17,9" "--region 130,70,100,100"; do
+        "$IMAGE" -d $flags "$WORK/flowers.c40" > "$WORK/y.ppm"
+        "$IMAGE" -d $flags "$WORK/flowers.t.c40" > "$WORK/x.ppm"
+        same "--tiled then -d $flags" "$WORK/x.ppm" "$WORK/y.ppm"
+        "$IMAGE" -d $flags < "$WORK/flowers.t.c40" > "$WORK/x.ppm"
+        same "--tiled then -d $flags from a pipe" "$WORK/x.ppm" "$WORK/y.ppm"
+done
+
+# a truncated format 3 file is rejected before anything is printed or
+# FILE is made, unless it is read from a pipe; a region that needs only
+# the tiles that are there is still printed. The image is three rows of
+# tiles tall, so a row of tiles printed too early would reach stdout
+noise 40 300 255 6 > "$WORK/tall.ppm"
+"$IMAGE" -c "$WORK/tall.ppm" > "$WORK/tall.c40"
+"$IMAGE" -c --tiled "$WORK/tall.ppm" > "$WORK/tall.t.c40"
+size=$(wc -c < "$WORK/tall.t.c40")
+head -c $((size - 100)) "$WORK/tall.t.c40" > "$WORK/short.t.c40"
+for flags in "" "-j 2" "--preview" "--region 0,280,10,10"; do
+        "$IMAGE" -d $flags "$WORK/short.t.c40" > "$WORK/x" 2> /dev/null &&
+                fail "-d${flags:+ $flags} on a short format 3 file succeeded"
+        [ -s "$WORK/x" ] &&
+                fail "-d${flags:+ $flags} on a short format 3 file printed"
+done
+"$IMAGE" -d -o "$WORK/short.ppm" "$WORK/short.t.c40" 2> /dev/null &&
+        fail "-d -o FILE on a short format 3 file succeeded"
+[ -e "$WORK/short.ppm" ] && fail "-d -o FILE on a short format 3 file made FILE"
+"$IMAGE" -d < "$WORK/short.t.c40" > /dev/null 2>&1 &&
+        fail "-d on a short format 3 pipe succeeded"
+"$IMAGE" -d --region 3,5,17,9 "$WORK/short.t.c40" > "$WORK/x.ppm"
+"$IMAGE" -d --region 3,5,17,9 "$WORK/tall.c40" > "$WORK/y.ppm"
+same "-d --region of the tiles a short format 3 file has" "$WORK/x.ppm" \
+        "$WORK/y.ppm"
+
+# a truncated file is rejected before anything is printed; it is long
+# enough that a PPM header printed too early would reach stdout
+head -c 10000 "$WORK/flowers.c40" > "$WORK/short.c40"
+for flags in "" "-j 2" "--staged" "--region 0,0,100,100" "--preview"; do
+        "$IMAGE" -d $flags "$WORK/short.c40" > "$WORK/x" 2> /dev/null &&
+                fail "-d${flags:+ $flags} on a short file succeeded"
+        [ -s "$WORK/x" ] && fail "-d${flags:+ $flags} on a short file printed"
+done
+# --stream prints each row as soon as it is decoded, so it can only fail
+"$IMAGE" -d --stream "$WORK/short.c40" > /dev/null 2>&1 &&
+        fail "-d --stream on a short file succeeded"
+"$IMAGE" -d < "$WORK/short.c40" > "$WORK/x" 2> /dev/null &&
+        fail "-d on a short pipe succeeded"
+[ -s "$WORK/x" ] && fail "-d on a short pipe printed"
+"$IMAGE" -d -o "$WORK/short.ppm" "$WORK/short.c40" 2> /dev/null &&
+        fail "-d -o FILE on a short file succeeded"
+[ -e "$WORK/short.ppm" ] && fail "-d -o FILE on a short file made FILE"
+
+# a sample above the maximum color value is a bad format
+printf 'P6\n2 2\n100\n\1\2\3\4\5\377\1\2\3\4\5\6' > "$WORK/over.ppm"
+printf 'P3\n2 2\n100\n1 2 3 4 5 200 1 2 3 4 5 6\n' > "$WORK/over3.ppm"
+for ppm in over.ppm over3.ppm; do
+        for flags in "" "--stream" "--staged"; do
+                "$IMAGE" -c $flags "$WORK/$ppm" > "$WORK/x" 2> /dev/null &&
+                        fail "-c${flags:+ $flags} took a sample over maxval"
+                [ -s "$WORK/x" ] &&
+                        fail "-c${flags:+ $flags} printed a sample over maxval"
+        done
+done
+
+# -d --region prints the crop of the decompressed image, cut out of it
+# with crop(); the corners are on and off a block, and the last region
+# runs past the right and bottom edges (flowers decompresses to 180x100)
+for test in "3,5,17,9 3 5 17 9" "0,0,1,1 0 0 1 1" \
+            "170,91,100,100 170 91 10 9"; do
+        set -- $test
+        crop "$WORK/flowers.out.ppm" 180 100 255 $2 $3 $4 $5 > "$WORK/crop.ppm"
+        "$IMAGE" -d --region $1 "$WORK/flowers.c40" > "$WORK/x.ppm"
+        same "-d --region $1" "$WORK/x.ppm" "$WORK/crop.ppm"
+        "$IMAGE" -d --region $1 < "$WORK/flowers.c40" > "$WORK/x.ppm"
+        same "-d --region $1 from a pipe" "$WORK/x.ppm" "$WORK/crop.ppm"
+done
+"$IMAGE" -d --region 180,0,1,1 "$WORK/flowers.c40" > "$WORK/x" 2> /dev/null &&
+        fail "-d --region outside the image succeeded"
+[ -s "$WORK/x" ] && fail "-d --region outside the image printed"
+
+# a compressed image whose width or height is odd is rejected by every
+# decoder; compress40() always drops the odd row and column
+header="COMP40 Compressed image format 2
+66 50
+"
+for size in "65 50" "66 49"; do
+        { printf 'COMP40 Compressed image format 2\n%s\n' "$size"
+          tail -c +$((${#header} + 1)) "$WORK/noise.c40"; } > "$WORK/odd.c40"
+        for flags in "" "--staged"; do
+                "$IMAGE" -d $flags "$WORK/odd.c40" > "$WORK/x" 2> /dev/null &&
+                        fail "-d${flags:+ $flags} took an odd size $size"
+                [ -s "$WORK/x" ] &&
+                        fail "-d${flags:+ $flags} printed an odd size $size"
+        done
+done
+
+"$IMAGE" -c -o > "$WORK/x" 2> /dev/null && fail "-o with no file name"
+[ -s "$WORK/x" ] && fail "-o with no file name printed"
+
+if [ $failures -ne 0 ]; then
+        echo "$failures checks failed"
+        exit 1
+fi
+echo "all checks passed"
@@ -0,0 +1,787 @@
+/**************************************************************
+ *                     tiled.c
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the implementations for compressTiled() and
+ *     decompressTiled(), which write and read the tiled compressed
+ *     format. Tiles are encoded on separate threads, and decoded one row
+ *     of tiles at a time with each tile of the row on its own thread.
+ *     Only the tiles that cover the pixels being printed are read: with
+ *     one pread() each when the input can be read at any offset, and in
+ *     order, skipping the rest, when it cannot. Tiles with checksums are
+ *     checked by the thread that decodes them, as they are decoded.
+ *
+ **************************************************************/
+#include "tiled.h"
+#include "handleImage.h"
+#include "ppmStream.h"
+#include "codeword.h"
+#include "options.h"
+#include "parallel.h"
+#include "crc32c.h"
+#include "outputTarget.h"
+#include "assert.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+/* the width and height of a tile in blocks when compressing; an enum so
+   the row buffers of encodeTileTask() are arrays of fixed size */
+enum { TILE_BLOCKS = 64 };
+
+/* bytes in one entry of the tile index: an offset and a size, and a
+   checksum if the tiles have them */
+static const size_t ENTRY_BYTES = 12;
+static const size_t CHECKSUM_BYTES = 4;
+
+/*
+ * Name:       Tile_layout
+ * Purpose:    Describes how the blocks of an image are split into tiles
+ * Components:
+ *             unsigned wordsWidth, wordsHeight: the size of the image in
+ *             blocks
+ *             unsigned tileWidth, tileHeight: the size of a tile in blocks;
+ *             the tiles on the right and bottom edges may be smaller
+ *             unsigned across, down: the number of columns and rows of
+ *             tiles
+ *             bool checksums: true if the index holds the CRC32C of each
+ *             tile
+ */
+struct Tile_layout {
+        unsigned wordsWidth, wordsHeight;
+        unsigned tileWidth, tileHeight;
+        unsigned across, down;
+        bool checksums;
+};
+
+/*
+ * Name:       Tile_entry
+ * Purpose:    Stores where one tile is in a compressed image
+ * Components:
+ *             uint64_t offset: the offset of the tile's first code word, in
+ *             bytes after the end of the index
+ *             uint32_t size: the number of bytes the tile is stored in
+ *             uint32_t crc: the CRC32C of those bytes, if the tiles have
+ *             checksums
+ */
+struct Tile_entry {
+        uint64_t offset;
+        uint32_t size;
+        uint32_t crc;
+};
+
+/*
+ * Name:       Tile_closure
+ * Purpose:    Stores what every thread needs to encode or decode its tiles
+ * Components:
+ *             struct Tile_layout layout: how the image is split into tiles
+ *             Pnm_ppm image: the image being compressed (encoding only)
+ *             uint32_t *words: every code word of the image, tile by tile,
+ *             when encoding. When decoding, room for the code words of
+ *             each tile of the row of tiles being decoded.
+ *             uint32_t *crcs: the checksum of every tile (encoding with
+ *             checksums only)
+ *             FILE *input: the image being decompressed, read with pread()
+ *             when payload is not -1 (decoding only)
+ *             off_t payload: the offset of the end of the index in input,
+ *             or -1 if input cannot be read at any offset (decoding only)
+ *             struct Tile_entry *index: where each tile is stored
+ *             (decoding only)
+ *             unsigned scale: the width and height in pixels that a block
+ *             is decoded to, 2 or 1 for a preview (decoding only)
+ *             unsigned firstCol, endCol, firstRow, endRow: the blocks that
+ *             cover the pixels being printed (decoding only)
+ *             unsigned firstTile: the first column of tiles being decoded
+ *             unsigned tileRow: the row of tiles being decoded
+ *             unsigned char *bytes: the pixels decoded from the row of
+ *             tiles, as a raw PPM stores them (decoding only)
+ *             size_t rowBytes: the length of one row of pixels in bytes
+ *             enum Engine engine: the arithmetic every tile is done in
+ */
+struct Tile_closure {
+        struct Tile_layout layout;
+        Pnm_ppm image;
+        uint32_t *words;
+        uint32_t *crcs;
+        FILE *input;
+        off_t payload;
+        struct Tile_entry *index;
+        unsigned scale;
+        unsigned firstCol, endCol, firstRow, endRow;
+        unsigned firstTile, tileRow;
+        unsigned char *bytes;
+        size_t rowBytes;
+        enum Engine engine;
+};
+
+static void startLayout(struct Tile_layout *layout, unsigned wordsWidth,
+                        unsigned wordsHeight, unsigned tileWidth,
+                        unsigned tileHeight);
+static void tileBounds(const struct Tile_layout *layout, unsigned tile,
+                       unsigned *col, unsigned *row, unsigned *width,
+                       unsigned *height);
+static size_t tileStart(const struct Tile_layout *layout, unsigned tile);
+static void encodeTileTask(int task, void *cl);
+static size_t entryBytes(const struct Tile_layout *layout);
+static void printTileIndex(const struct Tile_layout *layout,
+                           const uint32_t *crcs);
+static struct Tile_entry *readTileIndex(FILE *input,
+                                        const struct Tile_layout *layout);
+static void checkTilesPresent(const struct Tile_closure *cl,
+                              unsigned endTile, unsigned endTileRow);
+static void decodeTileRow(struct Tile_closure *cl,
+                          struct Input_source *source, size_t *position);
+static void decodeTileTask(int task, void *cl);
+static void printTileRow(struct Tile_closure *cl, struct Region region);
+static void putBigEndian(unsigned char *bytes, uint64_t value,
+                         unsigned count);
+static uint64_t getBigEndian(const unsigned char *bytes, unsigned count);
+static unsigned clampTile(unsigned tileSize, unsigned wordsSize);
+static size_t checkedMultiply(size_t a, size_t b);
+
+/*
+ * Name:       compressTiled
+ * Purpose:    Compresses an image into the tiled format and prints it to
+ *             stdout
+ * Parameters: Pnm_ppm image: the trimmed image to compress
+ * Return:     None
+ * Expects:    image to not be NULL and to have even dimensions
+ * Notes:      Tiles are TILE_BLOCKS blocks on a side and are encoded on
+ *             codecOptions.threads threads. Allocates and frees an array
+ *             holding every code word, since tiles may finish out of order.
+ *             The tiles are stored in the same order as the index, with no
+ *             gaps, so the image can also be read from a pipe.
+ *             Each tile gets a checksum if codecOptions.checksums is set,
+ *             computed by the thread that encodes it.
+ */
+void compressTiled(Pnm_ppm image)
+{
+        assert(image != NULL);
+        struct Tile_closure cl = { .image = image,
+                                   .engine = optionsEngine(&codecOptions) };
+        startLayout(&cl.layout, image->width / 2, image->height / 2,
+                    TILE_BLOCKS, TILE_BLOCKS);
+        cl.layout.checksums = codecOptions.checksums;
+
+        size_t tiles = (size_t) cl.layout.across * cl.layout.down;
+        size_t wordCount =
+                (size_t) cl.layout.wordsWidth * cl.layout.wordsHeight;
+        cl.words = malloc(wordCount * sizeof(uint32_t));
+        cl.crcs = malloc(tiles * sizeof(uint32_t) + 1);
+        assert((cl.words != NULL || wordCount == 0) && cl.crcs != NULL);
+
+        runParallel(codecOptions.threads, tiles, encodeTileTask, &cl);
+
+        printCompressedHeader(FORMAT_TILED, image->width, image->height);
+        printf("%u %u%s\n", cl.layout.tileWidth, cl.layout.tileHeight,
+               cl.layout.checksums ? " crc32c" : "");
+        printTileIndex(&cl.layout, cl.crcs);
+        printWords(cl.words, wordCount);
+
+        free(cl.words);
+        free(cl.crcs);
+}
+
+/*
+ * Name:       decompressTiled
+ * Purpose:    Decompresses a tiled image and prints it to stdout as a PPM
+ * Parameters: FILE *input: a pointer to an open file stream positioned just
+ *             after the size line of a FORMAT_TILED header
+ *             unsigned width: the width of the image from the header
+ *             unsigned height: the height of the image from the header
+ * Return:     None
+ * Expects:    input to not be NULL and the rest of the header and the tiles
+ *             to be well formed
+ * Notes:      will CRE if the header or index is malformed, a tile is
+ *             missing or fails its checksum, codecOptions.region starts
+ *             outside the image, or a buffer's size does not fit in a
+ *             size_t
+ *             A tile size larger than the image is cut down to the image
+ *             before any size is computed from it, which does not change
+ *             where any tile is
+ *             Prints only codecOptions.region if codecOptions.hasRegion is
+ *             set, and a half-resolution preview if codecOptions.preview
+ *             is set; only the tiles covering those pixels are read.
+ *             Holds one row of tiles in memory at a time.
+ *             Prints to the file codecOptions.output instead of stdout if
+ *             it is set. When input can be read at any offset, checks that
+ *             every tile it needs is there before the file is made or
+ *             anything is printed; a pipe is decoded as it arrives, so a
+ *             truncated one fails after some rows are printed.
+ */
+void decompressTiled(FILE *input, unsigned width, unsigned height)
+{
+        assert(input != NULL);
+        struct Tile_closure cl = { .input = input,
+                                   .scale = 2,
+                                   .engine = optionsEngine(&codecOptions) };
+        unsigned tileWidth, tileHeight;
+        int read = fscanf(input, "%u %u", &tileWidth, &tileHeight);
+        assert(read == 2 && tileWidth > 0 && tileHeight > 0);
+        tileWidth = clampTile(tileWidth, width / 2);
+        tileHeight = clampTile(tileHeight, height / 2);
+        startLayout(&cl.layout, width / 2, height / 2, tileWidth,
+                    tileHeight);
+        int c = getc(input);
+        if (c == ' ') {
+                char kind[8];
+                read = fscanf(input, "%7s", kind);
+                assert(read == 1 && strcmp(kind, "crc32c") == 0);
+                cl.layout.checksums = true;
+                c = getc(input);
+        }
+        assert(c == '\n');
+        cl.index = readTileIndex(input, &cl.layout);
+
+        struct Region region = { 0, 0, width, height };
+        if (codecOptions.preview) {
+                cl.scale = 1;
+                region.width = width / 2;
+                region.height = height / 2;
+        } else if (codecOptions.hasRegion) {
+                region = codecOptions.region;
+                assert(region.x < width && region.y < height);
+                if (region.width > width - region.x) {
+                        region.width = width - region.x;
+                }
+                if (region.height > height - region.y) {
+                        region.height = height - region.y;
+                }
+        }
+
+        cl.firstCol = region.x / cl.scale;
+        cl.endCol = (region.x + region.width + cl.scale - 1) / cl.scale;
+        cl.firstRow = region.y / cl.scale;
+        cl.endRow = (region.y + region.height + cl.scale - 1) / cl.scale;
+        assert(cl.endCol <= cl.layout.wordsWidth &&
+               cl.endRow <= cl.layout.wordsHeight);
+        cl.firstTile = cl.firstCol / tileWidth;
+        unsigned endTile = (cl.endCol + tileWidth - 1) / tileWidth;
+        unsigned tiles = endTile - cl.firstTile;
+        unsigned endTileRow = (cl.endRow + tileHeight - 1) / tileHeight;
+
+        cl.rowBytes = checkedMultiply(cl.endCol - cl.firstCol,
+                                      cl.scale * 3);
+        size_t tileWords = checkedMultiply(tileWidth, tileHeight);
+        size_t byteCount = checkedMultiply(cl.rowBytes, tileHeight * cl.scale);
+        size_t wordCount = checkedMultiply(tiles, tileWords);
+        cl.bytes = malloc(byteCount + 1);
+        cl.words = malloc(checkedMultiply(wordCount, sizeof(uint32_t)) + 1);
+        assert(cl.bytes != NULL && cl.words != NULL);
+
+        struct Input_source source;
+        size_t position = 0;
+        cl.payload = ftello(input);
+        if (cl.payload == -1) {
+                openInputSource(input, &source);
+        } else {
+                checkTilesPresent(&cl, endTile, endTileRow);
+        }
+
+        if (codecOptions.output != NULL) {
+                redirectOutput(codecOptions.output);
+        }
+        printPPMHeader(stdout, region.width, region.height, 255);
+        for (cl.tileRow = cl.firstRow / tileHeight; cl.tileRow < endTileRow;
+             cl.tileRow++) {
+                decodeTileRow(&cl, &source, &position);
+                printTileRow(&cl, region);
+        }
+
+        if (cl.payload == -1) {
+                closeInputSource(&source);
+        }
+        free(cl.index);
+        free(cl.bytes);
+        free(cl.words);
+}
+
+/*
+ * Name:       startLayout
+ * Purpose:    a private function that splits an image into tiles
+ * Parameters: struct Tile_layout *layout: where the layout is stored
+ *             unsigned wordsWidth, wordsHeight: the size of the image in
+ *             blocks
+ *             unsigned tileWidth, tileHeight: the size of a tile in blocks
+ * Return:     None
+ * Expects:    layout to not be NULL and the tile sizes to be positive
+ * Notes:      None
+ */
+static void startLayout(struct Tile_layout *layout, unsigned wordsWidth,
+                        unsigned wordsHeight, unsigned tileWidth,
+                        unsigned tileHeight)
+{
+        assert(layout != NULL && tileWidth > 0 && tileHeight > 0);
+        layout->wordsWidth = wordsWidth;
+        layout->wordsHeight = wordsHeight;
+        layout->tileWidth = tileWidth;
+        layout->tileHeight = tileHeight;
+        layout->across = (wordsWidth + tileWidth - 1) / tileWidth;
+        layout->down = (wordsHeight + tileHeight - 1) / tileHeight;
+        layout->checksums = false;
+}
+
+/*
+ * Name:       tileBounds
+ * Purpose:    a private function that finds the blocks a tile covers
+ * Parameters: const struct Tile_layout *layout: how the image is tiled
+ *             unsigned tile: the number of the tile, in row-major order
+ *             unsigned *col, *row: where the column and row of the tile's
+ *             top-left block are stored
+ *             unsigned *width, *height: where the size of the tile in
+ *             blocks is stored
+ * Return:     None
+ * Expects:    no pointer to be NULL and tile to be in the layout
+ * Notes:      None
+ */
+static void tileBounds(const struct Tile_layout *layout, unsigned tile,
+                       unsigned *col, unsigned *row, unsigned *width,
+                       unsigned *height)
+{
+        assert(layout != NULL && col != NULL && row != NULL);
+        assert(width != NULL && height != NULL);
+        *col = tile % layout->across * layout->tileWidth;
+        *row = tile / layout->across * layout->tileHeight;
+        *width = layout->wordsWidth - *col < layout->tileWidth
+                         ? layout->wordsWidth - *col
+                         : layout->tileWidth;
+        *height = layout->wordsHeight - *row < layout->tileHeight
+                          ? layout->wordsHeight - *row
+                          : layout->tileHeight;
+}
+
+/*
+ * Name:       tileStart
+ * Purpose:    a private function that finds where a tile's code words
+ *             start when every tile is stored in order with no gaps
+ * Parameters: const struct Tile_layout *layout: how the image is tiled
+ *             unsigned tile: the number of the tile, in row-major order
+ * Return:     the number of code words stored before the tile
+ * Expects:    layout to not be NULL and tile to be in the layout
+ * Notes:      Every row of tiles above covers the full width of the image,
+ *             and every tile to the left in the same row is full width.
+ */
+static size_t tileStart(const struct Tile_layout *layout, unsigned tile)
+{
+        unsigned col, row, width, height;
+        tileBounds(layout, tile, &col, &row, &width, &height);
+        return (size_t) row * layout->wordsWidth + (size_t) col * height;
+}
+
+/*
+ * Name:       encodeTileTask
+ * Purpose:    a private function that encodes every block of one tile
+ *             into its code word. Run once per tile by runParallel().
+ * Parameters: int task: the number of the tile to encode
+ *             void *cl: a pointer to a Tile_closure holding the image and
+ *             the array of code words
+ * Return:     None
+ * Expects:    cl to not be NULL and task to be a tile of the layout
+ * Notes:      only writes the code words of its own tile
+ *             Converts the colors of each row of the tile at once with
+ *             rgbRowsToWords()
+ */
+static void encodeTileTask(int task, void *cl)
+{
+        struct Tile_closure *closure = cl;
+        Pnm_ppm image = closure->image;
+        unsigned col, row, width, height;
+        tileBounds(&closure->layout, task, &col, &row, &width, &height);
+
+        struct Pnm_rgb copies[4 * TILE_BLOCKS];
+        struct YPbPr_pixel converted[4 * TILE_BLOCKS];
+        assert(width <= TILE_BLOCKS);
+
+        uint32_t *words = closure->words + tileStart(&closure->layout, task);
+        for (unsigned r = row; r < row + height; r++) {
+                const struct Pnm_rgb *top = imagePixels(image, 2 * col, 2 * r,
+                                                        2 * width, copies);
+                const struct Pnm_rgb *bottom =
+                        imagePixels(image, 2 * col, 2 * r + 1, 2 * width,
+                                    copies + 2 * width);
+                rgbRowsToWords(top, bottom, width, image->denominator,
+                               converted, words + (size_t) (r - row) * width,
+                               closure->engine);
+        }
+
+        if (closure->layout.checksums) {
+                closure->crcs[task] =
+                        crc32cWords(0, words, (size_t) width * height);
+        }
+}
+
+/*
+ * Name:       entryBytes
+ * Purpose:    a private function that finds the length of one entry of
+ *             the tile index
+ * Parameters: const struct Tile_layout *layout: how the image is tiled
+ * Return:     the number of bytes in each entry
+ * Expects:    layout to not be NULL
+ * Notes:      None
+ */
+static size_t entryBytes(const struct Tile_layout *layout)
+{
+        return ENTRY_BYTES + (layout->checksums ? CHECKSUM_BYTES : 0);
+}
+
+/*
+ * Name:       printTileIndex
+ * Purpose:    a private function that prints the index of a tiled image
+ *             whose tiles are stored in order with no gaps
+ * Parameters: const struct Tile_layout *layout: how the image is tiled
+ *             const uint32_t *crcs: the checksum of every tile, only used
+ *             if layout->checksums is set
+ * Return:     None
+ * Expects:    layout to not be NULL
+ * Notes:      will CRE if stdout cannot be written to
+ */
+static void printTileIndex(const struct Tile_layout *layout,
+                           const uint32_t *crcs)
+{
+        assert(layout != NULL);
+        size_t tiles = (size_t) layout->across * layout->down;
+        size_t length = entryBytes(layout);
+        unsigned char *bytes = malloc(tiles * length + 1);
+        assert(bytes != NULL);
+
+        for (size_t tile = 0; tile < tiles; tile++) {
+                unsigned col, row, width, height;
+                tileBounds(layout, tile, &col, &row, &width, &height);
+                unsigned char *entry = bytes + tile * length;
+                putBigEndian(entry, tileStart(layout, tile) * 4, 8);
+                putBigEndian(entry + 8, (uint64_t) width * height * 4, 4);
+                if (layout->checksums) {
+                        putBigEndian(entry + ENTRY_BYTES, crcs[tile],
+                                     CHECKSUM_BYTES);
+                }
+        }
+
+        size_t written = fwrite(bytes, length, tiles, stdout);
+        assert(written == tiles);
+        free(bytes);
+}
+
+/*
+ * Name:       readTileIndex
+ * Purpose:    a private function that reads the index of a tiled image
+ * Parameters: FILE *input: a pointer to an open file stream positioned at
+ *             the start of the index
+ *             const struct Tile_layout *layout: how the image is tiled
+ * Return:     an array with the entry of every tile, which the caller must
+ *             free
+ * Expects:    input and layout to not be NULL
+ * Notes:      will CRE if the index is cut short or a tile's size does not
+ *             match the number of blocks it covers
+ *             leaves input at the end of the index
+ */
+static struct Tile_entry *readTileIndex(FILE *input,
+                                        const struct Tile_layout *layout)
+{
+        assert(input != NULL && layout != NULL);
+        size_t tiles = (size_t) layout->across * layout->down;
+        size_t length = entryBytes(layout);
+        unsigned char *bytes = malloc(checkedMultiply(tiles, length) + 1);
+        struct Tile_entry *index =
+                malloc(checkedMultiply(tiles, sizeof(*index)) + 1);
+        assert(bytes != NULL && index != NULL);
+
+        size_t read = fread(bytes, length, tiles, input);
+        assert(read == tiles);
+
+        for (size_t tile = 0; tile < tiles; tile++) {
+                unsigned col, row, width, height;
+                tileBounds(layout, tile, &col, &row, &width, &height);
+                const unsigned char *entry = bytes + tile * length;
+                index[tile].offset = getBigEndian(entry, 8);
+                index[tile].size = getBigEndian(entry + 8, 4);
+                index[tile].crc = 0;
+                if (layout->checksums) {
+                        index[tile].crc = getBigEndian(entry + ENTRY_BYTES,
+                                                       CHECKSUM_BYTES);
+                }
+                assert(index[tile].size == (uint64_t) width * height * 4);
+        }
+
+        free(bytes);
+        return index;
+}
+
+/*
+ * Name:       checkTilesPresent
+ * Purpose:    a private function that checks that input holds every tile
+ *             a decode needs
+ * Parameters: const struct Tile_closure *cl: the tiles being decoded, from
+ *             a file that can be read at any offset
+ *             unsigned endTile: one past the last column of tiles needed
+ *             unsigned endTileRow: one past the last row of tiles needed
+ * Return:     None
+ * Expects:    cl to not be NULL and cl->payload to not be -1
+ * Notes:      will CRE if the input ends before the end of any tile
+ *             needed. Tiles may be stored in any order, so it finds the
+ *             one that ends last and reads its last code word.
+ */
+static void checkTilesPresent(const struct Tile_closure *cl,
+                              unsigned endTile, unsigned endTileRow)
+{
+        assert(cl != NULL && cl->payload != -1);
+        const struct Tile_layout *layout = &cl->layout;
+        uint64_t end = 0;
+        for (unsigned row = cl->firstRow / layout->tileHeight;
+             row < endTileRow; row++) {
+                for (unsigned col = cl->firstTile; col < endTile; col++) {
+                        struct Tile_entry entry =
+                                cl->index[row * layout->across + col];
+                        assert(entry.offset <= UINT64_MAX - entry.size);
+                        if (entry.offset + entry.size > end) {
+                                end = entry.offset + entry.size;
+                        }
+                }
+        }
+        if (end == 0) {
+                return;
+        }
+
+        /* every tile is at least one code word of 4 bytes */
+        uint32_t word;
+        assert(end <= (uint64_t) INT64_MAX - cl->payload);
+        bool read = readWordsAt(cl->input, cl->payload + (off_t) end - 4,
+                                &word, 1);
+        assert(read);
+}
+
+/*
+ * Name:       decodeTileRow
+ * Purpose:    a private function that decodes the tiles of cl->tileRow
+ *             that cover the pixels being printed into cl->bytes
+ * Parameters: struct Tile_closure *cl: the decoding state
+ *             struct Input_source *source: the open source the tiles are
+ *             read from when cl->payload is -1
+ *             size_t *position: how many bytes after the index have been
+ *             read from source
+ * Return:     None
+ * Expects:    cl, source, and position to not be NULL
+ * Notes:      will CRE if the input ends early, or if it cannot be read at
+ *             any offset and the tiles needed are not stored in order
+ *             Tiles are read here, in order, when the input is a pipe;
+ *             otherwise each thread reads its own tile with pread().
+ */
+static void decodeTileRow(struct Tile_closure *cl,
+                          struct Input_source *source, size_t *position)
+{
+        assert(cl != NULL && source != NULL && position != NULL);
+        const struct Tile_layout *layout = &cl->layout;
+        unsigned endTile =
+                (cl->endCol + layout->tileWidth - 1) / layout->tileWidth;
+        int tiles = endTile - cl->firstTile;
+
+        for (int task = 0; cl->payload == -1 && task < tiles; task++) {
+                unsigned tile = cl->tileRow * layout->across +
+                                cl->firstTile + task;
+                struct Tile_entry entry = cl->index[tile];
+                assert(entry.offset >= *position);
+                bool skipped = skipInputBytes(source,
+                                              entry.offset - *position);
+                assert(skipped);
+
+                uint32_t *words = cl->words + (size_t) task *
+                                                      layout->tileWidth *
+                                                      layout->tileHeight;
+                readWords(source, words, entry.size / 4);
+                *position = entry.offset + entry.size;
+        }
+
+        runParallel(codecOptions.threads, tiles, decodeTileTask, cl);
+}
+
+/*
+ * Name:       decodeTileTask
+ * Purpose:    a private function that decodes the blocks of one tile that
+ *             cover the pixels being printed. Run once per tile of the
+ *             row of tiles by runParallel().
+ * Parameters: int task: which tile of the row to decode, counting from
+ *             cl->firstTile
+ *             void *cl: a pointer to the Tile_closure being decoded
+ * Return:     None
+ * Expects:    cl to not be NULL
+ * Notes:      reports a CRE to runParallel() if the tile cannot be read,
+ *             fails its checksum, or its row buffer cannot be allocated
+ *             only writes its own tile's code words and pixels
+ *             the row buffer is sized from the tile width in the header,
+ *             which may be larger than TILE_BLOCKS
+ */
+static void decodeTileTask(int task, void *cl)
+{
+        struct Tile_closure *closure = cl;
+        const struct Tile_layout *layout = &closure->layout;
+        unsigned tile = closure->tileRow * layout->across +
+                        closure->firstTile + task;
+        unsigned col, row, width, height;
+        tileBounds(layout, tile, &col, &row, &width, &height);
+
+        uint32_t *words = closure->words + (size_t) task * layout->tileWidth *
+                                                   layout->tileHeight;
+        if (closure->payload != -1 &&
+            !readWordsAt(closure->input,
+                         closure->payload + closure->index[tile].offset,
+                         words, (size_t) width * height)) {
+                TASK_RAISE(Assert_Failed);
+                return;
+        }
+        if (layout->checksums &&
+            crc32cWords(0, words, (size_t) width * height) !=
+                    closure->index[tile].crc) {
+                TASK_RAISE(Assert_Failed);
+                return;
+        }
+
+        unsigned firstCol = col > closure->firstCol ? col : closure->firstCol;
+        unsigned endCol = col + width < closure->endCol ? col + width
+                                                        : closure->endCol;
+        unsigned firstRow = row > closure->firstRow ? row : closure->firstRow;
+        unsigned endRow = row + height < closure->endRow ? row + height
+                                                         : closure->endRow;
+        unsigned scale = closure->scale;
+        size_t rowBytes = closure->rowBytes;
+
+        struct YPbPr_pixel *converted =
+                malloc((4 * (size_t) layout->tileWidth + 1) *
+                       sizeof(struct YPbPr_pixel));
+        if (converted == NULL) {
+                TASK_RAISE(Assert_Failed);
+                return;
+        }
+
+        for (unsigned r = firstRow; r < endRow; r++) {
+                unsigned char *out = closure->bytes +
+                                     (r - row) * scale * rowBytes +
+                                     (firstCol - closure->firstCol) *
+                                             scale * 3;
+                const uint32_t *rowWords =
+                        words + (r - row) * width + firstCol - col;
+                if (scale == 2) {
+                        wordsToBytes(rowWords, endCol - firstCol, converted,
+                                     out, out + rowBytes, closure->engine);
+                } else {
+                        wordsToPreviewBytes(rowWords, endCol - firstCol,
+                                            converted, out, closure->engine);
+                }
+        }
+
+        free(converted);
+}
+
+/*
+ * Name:       printTileRow
+ * Purpose:    a private function that prints the pixels of the region
+ *             that were decoded from cl->tileRow
+ * Parameters: struct Tile_closure *cl: the decoding state
+ *             struct Region region: the pixels being printed
+ * Return:     None
+ * Expects:    cl to not be NULL
+ * Notes:      will CRE if stdout cannot be written to
+ */
+static void printTileRow(struct Tile_closure *cl, struct Region region)
+{
+        assert(cl != NULL);
+        unsigned scale = cl->scale;
+        unsigned firstRow = cl->tileRow * cl->layout.tileHeight * scale;
+        unsigned endRow = firstRow + cl->layout.tileHeight * scale;
+        if (firstRow < region.y) {
+                firstRow = region.y;
+        }
+        if (endRow > region.y + region.height) {
+                endRow = region.y + region.height;
+        }
+
+        size_t skip = (size_t) (region.x - cl->firstCol * scale) * 3;
+        size_t length = (size_t) region.width * 3;
+        for (unsigned row = firstRow; row < endRow; row++) {
+                unsigned bandRow =
+                        row - cl->tileRow * cl->layout.tileHeight * scale;
+                size_t written = fwrite(cl->bytes + bandRow * cl->rowBytes +
+                                                skip,
+                                        1, length, stdout);
+                assert(written == length);
+        }
+}
+
+/*
+ * Name:       putBigEndian
+ * Purpose:    a private function that stores a number in big-endian order
+ * Parameters: unsigned char *bytes: where the number is stored
+ *             uint64_t value: the number
+ *             unsigned count: the number of bytes to store it in
+ * Return:     None
+ * Expects:    bytes to have room for count bytes
+ * Notes:      None
+ */
+static void putBigEndian(unsigned char *bytes, uint64_t value,
+                         unsigned count)
+{
+        for (unsigned i = count; i > 0; i--) {
+                bytes[i - 1] = value;
+                value >>= 8;
+        }
+}
+
+/*
+ * Name:       getBigEndian
+ * Purpose:    a private function that reads a number stored in big-endian
+ *             order
+ * Parameters: const unsigned char *bytes: where the number is stored
+ *             unsigned count: the number of bytes it is stored in
+ * Return:     the number
+ * Expects:    bytes to hold count bytes
+ * Notes:      None
+ */
+static uint64_t getBigEndian(const unsigned char *bytes, unsigned count)
+{
+        uint64_t value = 0;
+        for (unsigned i = 0; i < count; i++) {
+                value = value << 8 | bytes[i];
+        }
+        return value;
+}
+
+/*
+ * Name:       clampTile
+ * Purpose:    a private function that cuts a tile size read from a header
+ *             down to the size of the image
+ * Parameters: unsigned tileSize: the width or height of a tile in blocks
+ *             unsigned wordsSize: the width or height of the image in
+ *             blocks
+ * Return:     the smaller of the two, but at least 1
+ * Expects:    tileSize to be positive
+ * Notes:      a tile at least as large as the image is one tile across (or
+ *             down) either way, so this never moves a tile
+ */
+static unsigned clampTile(unsigned tileSize, unsigned wordsSize)
+{
+        if (wordsSize == 0) {
+                return 1;
+        }
+        return tileSize < wordsSize ? tileSize : wordsSize;
+}
+
+/*
+ * Name:       checkedMultiply
+ * Purpose:    a private function that multiplies two sizes
+ * Parameters: size_t a, b: the sizes to multiply
+ * Return:     a * b
+ * Expects:    None
+ * Notes:      will CRE if a * b does not fit in a size_t, so a crafted
+ *             header cannot make a buffer smaller than what is written to
+ *             it
+ */
+static size_t checkedMultiply(size_t a, size_t b)
+{
+        assert(a == 0 || b <= SIZE_MAX / a);
+        return a * b;
+}
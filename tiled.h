@@ -0,0 +1,32 @@
+/**************************************************************
+ *                     tiled.h
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary:
+ *
+ *     This file contains the function declarations for tiled.c, which
+ *     writes and reads the tiled compressed format (FORMAT_TILED). Its
+ *     header is the usual format and size lines, then a line with the
+ *     width and height of a tile in blocks, followed by the word crc32c
+ *     if the tiles have checksums. Then comes an index with one entry per
+ *     tile in row-major order: the tile's offset in bytes after the end
+ *     of the index (8 bytes), its size in bytes (4 bytes), and, if the
+ *     tiles have checksums, the CRC32C of its bytes (4 bytes), all
+ *     big-endian. Each tile stores the code words of its blocks in
+ *     row-major order, so any tile can be read and decoded on its own.
+ *
+ **************************************************************/
+#ifndef TILED_H
+#define TILED_H
+
+#include <stdio.h>
+#include "pnm.h"
+
+void compressTiled(Pnm_ppm image);
+void decompressTiled(FILE *input, unsigned width, unsigned height);
+
+#endif
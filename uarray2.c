@@ -11,78 +11,108 @@
  *     This file contains the implementation for a UArray2. It
  *     implements the functions declared in uarray2.h.
  * 
- *     NOTE: This file was provided by the course
+ *     NOTE: This file was provided by the course. It has been changed to
+ *     keep every element in one contiguous allocation, so finding an
+ *     element is a multiply and an add instead of two UArray_at calls.
  *
  **************************************************************/
 
+#include <stdint.h>
 #include <stdlib.h>
 
 #include "assert.h"
 #include "mem.h"
-#include "uarray.h"
 #include "uarray2.h"
 
 #define T UArray2_T
 
+/* the first element is aligned to a cache line */
+#define ALIGNMENT 64
+
 /* 
- * Element (i, j) in the world of ideas maps to
- * rows[j][i] where the square brackets stand for access
- * to a Hanson UArray_T
+ * Element (i, j) in the world of ideas maps to the 'size' bytes at
+ * elems + j * stride + i * size, so stride is at least width * size.
+ * An array from UArray2_new stores its rows one after another with no
+ * padding, so its stride is exactly width * size; a view keeps its
+ * parent's stride, which is larger when the view is narrower.
  */
 struct T {
         int width, height;
         int size;
-        UArray_T rows; /* UArray_T of 'height' UArray_Ts,
-                          each of length 'width' and size 'size' */
+        long stride;  /* bytes from the start of one row to the next */
+        char *elems;  /* first element, aligned to ALIGNMENT bytes */
+        void *memory; /* what was allocated, so it can be freed; NULL for a
+                         view, which borrows another array's elements */
 };
 
-static inline UArray_T row(T a, int j)
-{
-        UArray_T *prow = UArray_at(a->rows, j); /* Ramsey idiom */
-        return *prow;
-}
-
 static int is_ok(T a)
 {
-        return a && UArray_length(a->rows) == a->height &&
-               UArray_size(a->rows) == sizeof(UArray_T) &&
-               (a->height == 0 || (UArray_length(row(a, 0)) == a->width &&
-                                   UArray_size(row(a, 0)) == a->size));
+        return a && a->width >= 0 && a->height >= 0 && a->size > 0 &&
+               a->stride >= (long) a->width * a->size &&
+               (a->memory == NULL || (uintptr_t) a->elems % ALIGNMENT == 0);
 }
 
 T UArray2_new(int width, int height, int size)
 {
-        int i; /* interates over row number */
         T array;
+        assert(width >= 0 && height >= 0 && size > 0);
         NEW(array);
         array->width = width;
         array->height = height;
         array->size = size;
-        array->rows = UArray_new(height, sizeof(UArray_T));
-        for (i = 0; i < height; i++) {
-                UArray_T *rowp = UArray_at(array->rows, i);
-                *rowp = UArray_new(width, size);
-        }
+        array->stride = (long) width * size;
+        /* CALLOC keeps elements zeroed, just like UArray_new */
+        array->memory = CALLOC(1, array->stride * height + ALIGNMENT);
+        array->elems = (char *) (((uintptr_t) array->memory + ALIGNMENT - 1) &
+                                 ~(uintptr_t) (ALIGNMENT - 1));
         assert(is_ok(array));
         return array;
 }
 
+/*
+ * a view keeps the parent's stride, so its rows are still contiguous and
+ * UArray2_row, the maps, and span_at work on it unchanged
+ */
+T UArray2_view(T parent, int i, int j, int width, int height)
+{
+        T view;
+        assert(parent != NULL);
+        assert(i >= 0 && j >= 0 && width >= 0 && height >= 0);
+        assert(i + width <= parent->width && j + height <= parent->height);
+        NEW(view);
+        view->width = width;
+        view->height = height;
+        view->size = parent->size;
+        view->stride = parent->stride;
+        view->elems = parent->elems + j * parent->stride +
+                      (long) i * parent->size;
+        view->memory = NULL;
+        assert(is_ok(view));
+        return view;
+}
+
 void UArray2_free(T *array2)
 {
-        int i;
         assert(array2 != NULL && *array2 != NULL);
-        for (i = 0; i < (*array2)->height; i++) {
-                UArray_T p = row(*array2, i);
-                UArray_free(&p);
+        if ((*array2)->memory != NULL) {
+                FREE((*array2)->memory);
         }
-        UArray_free(&(*array2)->rows);
         FREE(*array2);
 }
 
 void *UArray2_at(T array2, int i, int j)
 {
         assert(array2 != NULL);
-        return UArray_at(row(array2, j), i);
+        assert((unsigned) i < (unsigned) array2->width &&
+               (unsigned) j < (unsigned) array2->height);
+        return array2->elems + j * array2->stride + (long) i * array2->size;
+}
+
+void *UArray2_row(T array2, int j)
+{
+        assert(array2 != NULL);
+        assert((unsigned) j < (unsigned) array2->height);
+        return array2->elems + j * array2->stride;
 }
 
 int UArray2_height(T array2)
@@ -113,12 +143,13 @@ void UArray2_map_row_major(T array2,
 
         int h = array2->height; /* keeping height and width in registers */
         int w = array2->width; /* avoids extra memory traffic           */
+        int size = array2->size;
 
         for (int j = 0; j < h; j++) {
-                /* don't want row/UArray_at in inner loop */
-                UArray_T thisrow = row(array2, j);
+                char *elem = array2->elems + j * array2->stride;
                 for (int i = 0; i < w; i++) {
-                        apply(i, j, array2, UArray_at(thisrow, i), cl);
+                        apply(i, j, array2, elem, cl);
+                        elem += size;
                 }
         }
 }
@@ -133,10 +164,13 @@ void UArray2_map_col_major(T array2,
 
         int h = array2->height; /* keeping height and width in registers */
         int w = array2->width; /* avoids extra memory traffic           */
+        long stride = array2->stride;
 
         for (int i = 0; i < w; i++) {
+                char *elem = array2->elems + (long) i * array2->size;
                 for (int j = 0; j < h; j++) {
-                        apply(i, j, array2, UArray_at(row(array2, j), i), cl);
+                        apply(i, j, array2, elem, cl);
+                        elem += stride;
                 }
         }
-}
\ No newline at end of file
+}
@@ -25,11 +25,19 @@ typedef void UArray2_applyfun(int i, int j, T array2, void *elem, void *cl);
 typedef void UArray2_mapfun(T array2, UArray2_applyfun apply, void *cl);
 
 extern T UArray2_new(int width, int height, int size);
+/*
+ * a view is a width by height window of parent starting at (i, j) that
+ * shares parent's elements; UArray2_free on a view leaves them alone, and
+ * parent must outlive the view
+ */
+extern T UArray2_view(T parent, int i, int j, int width, int height);
 extern void UArray2_free(T *array2);
 extern int UArray2_width(T array2);
 extern int UArray2_height(T array2);
 extern int UArray2_size(T array2);
 extern void *UArray2_at(T array2, int i, int j);
+/* all elements of row j are contiguous; returns element (0, j) */
+extern void *UArray2_row(T array2, int j);
 extern void UArray2_map_row_major(T array2, UArray2_applyfun apply, void *cl);
 extern void UArray2_map_col_major(T array2, UArray2_applyfun apply, void *cl);
 #undef T
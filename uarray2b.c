@@ -1,5 +1,5 @@
 /**************************************************************
- *                     uarray2.c
+ *                     uarray2b.c
  *
  *     Assignment: arith
  *     Authors:  Diana Calderon and Madeline Lei
@@ -12,97 +12,121 @@
  *     whose elements are stored in blocks. It implements the functions 
  *     declared in uarray2b.h.
  * 
- *     NOTE: This file was provided by the course
+ *     NOTE: This file was provided by the course. It has been changed to
+ *     keep every block in one slab of memory and to use power-of-two
+ *     blocks, so finding an element takes shifts and masks. Any other
+ *     blocksize is a checked runtime error (see uarray2b.h).
  *
  **************************************************************/
 
-#include <math.h>
+#include <stdint.h>
 #include "assert.h"
 #include "mem.h"
-#include "uarray.h"
-#include "uarray2.h"
 #include "uarray2b.h"
 
 #define T UArray2b_T
 
+/* the slab is aligned to a cache line */
+#define ALIGNMENT 64
+
 struct T { /* represents a 2D array of cells each of size 'size' */
         int width, height;
-        unsigned blocksize;
+        unsigned blocksize; /* always a power of two */
+        unsigned shift;     /* log2(blocksize) */
+        unsigned mask;      /* blocksize - 1 */
         unsigned size;
-        UArray2_T blocks;
+        int xblocks, yblocks;
+        int col0, row0; /* where (0, 0) is in the slab; 0 except in views */
+        char *slab;
+        void *memory; /* what was allocated, so it can be freed; NULL for a
+                         view, which borrows another array's slab */
         /*
-         * matrix of blocks, each blocksize * blocksize 
+         * xblocks * yblocks blocks, each blocksize * blocksize cells,
+         * stored back to back in slab
          *
-         * matrix dimensions are width and height divided by blocksize,
+         * xblocks and yblocks are width and height divided by blocksize,
          * rounded up
          *
-         * a block is a Uarray_T of length blocksize * blocksize 
-         * and size 'size'
+         * blocks are stored in the order UArray2b_map visits them, so
+         * block (bx, by) is block number bx * yblocks + by, and the
+         * cell for (i, j) inside its block is number
+         * (i % blocksize) * blocksize + j % blocksize. A map is then a
+         * single sweep through slab.
          *
-         * invariant relating cells in blocks to cells in the abstraction
-         *  described in section on coordinate transformations below
+         * xblocks, yblocks, and the cell numbers above are all in the
+         * coordinates of the array that owns the slab. A view adds
+         * (col0, row0) to its own coordinates to get there.
          */
 };
 
-#include <stdio.h> /* include so we can print diagnostics */
-
 T UArray2b_new(int width, int height, int size, int blocksize)
 {
-        assert(blocksize > 0);
+        assert(blocksize > 0 && size > 0);
+        assert((blocksize & (blocksize - 1)) == 0);
+        assert(width >= 0 && height >= 0);
         T array;
         NEW(array);
         array->width = width;
         array->height = height;
         array->size = size;
-        array->blocksize = blocksize;
-        array->blocks = UArray2_new((width + blocksize - 1) / blocksize,
-                                    (height + blocksize - 1) / blocksize,
-                                    sizeof(UArray_T));
-        int xblocks = UArray2_width(array->blocks);
-        int yblocks = UArray2_height(array->blocks);
-        for (int i = 0; i < xblocks; i++) {
-                for (int j = 0; j < yblocks; j++) {
-                        UArray_T *block = UArray2_at(array->blocks, i, j);
-                        *block = UArray_new(blocksize * blocksize, size);
-
-                        if (0) {
-                                fprintf(stderr, "Allocated %p; put %p at %p\n",
-                                        (void *) *block,
-                                        (void *) *(UArray_T *) UArray2_at(
-                                                array->blocks, i, j),
-                                        UArray2_at(array->blocks, i, j));
-                        }
-                }
+
+        /* blocksize is a power of two, so this is exactly log2 of it */
+        array->shift = 0;
+        while ((blocksize >> (array->shift + 1)) > 0) {
+                array->shift++;
         }
+        array->blocksize = blocksize;
+        array->mask = array->blocksize - 1;
+
+        array->xblocks = (width + array->mask) >> array->shift;
+        array->yblocks = (height + array->mask) >> array->shift;
+        array->col0 = 0;
+        array->row0 = 0;
+
+        long cells = (long) array->xblocks * array->yblocks
+                     << (2 * array->shift);
+        array->memory = CALLOC(1, cells * size + ALIGNMENT);
+        array->slab = (char *) (((uintptr_t) array->memory + ALIGNMENT - 1) &
+                                ~(uintptr_t) (ALIGNMENT - 1));
+
         return array;
 }
 
+T UArray2b_view(T parent, int i, int j, int width, int height)
+{
+        T view;
+        assert(parent != NULL);
+        assert(i >= 0 && j >= 0 && width >= 0 && height >= 0);
+        assert(i + width <= parent->width && j + height <= parent->height);
+        NEW(view);
+        *view = *parent;
+        view->width = width;
+        view->height = height;
+        view->col0 = parent->col0 + i;
+        view->row0 = parent->row0 + j;
+        view->memory = NULL;
+        return view;
+}
+
 void UArray2b_free(T *array2b)
 {
-        int i;
         assert(array2b && *array2b);
-        T array = *array2b;
-        int xblocks = UArray2_width(array->blocks);
-        int yblocks = UArray2_height(array->blocks);
-        assert(UArray2_size(array->blocks) == sizeof(UArray_T));
-        for (i = 0; i < xblocks; i++) {
-                for (int j = 0; j < yblocks; j++) {
-                        UArray_T *p = UArray2_at(array->blocks, i, j);
-                        UArray_free(p);
-                }
+        if ((*array2b)->memory != NULL) {
+                FREE((*array2b)->memory);
         }
-        UArray2_free(&(*array2b)->blocks);
         FREE(*array2b);
 }
 
 T UArray2b_new_64K_block(int width, int height, int size)
 {
-        int blocksize = (int) floor(sqrt((double) (64 * 1024) / (double) size));
-        if (blocksize == 0) {
-                blocksize = 1;
+        assert(size > 0);
+        /* the biggest power of two whose block fits in 64KB */
+        int blocksize = 1;
+        while ((long) (2 * blocksize) * (2 * blocksize) * size <= 64 * 1024) {
+                blocksize *= 2;
         }
         /*  assert as big as possible */
-        assert((blocksize + 1) * (blocksize + 1) * size > 64 * 1024);
+        assert((long) (2 * blocksize) * (2 * blocksize) * size > 64 * 1024);
         if (size <= 64 * 1024) { /* but no bigger */
                 assert(blocksize * blocksize * size <= 64 * 1024);
         }
@@ -112,14 +136,16 @@ T UArray2b_new_64K_block(int width, int height, int size)
 void *UArray2b_at(T array2b, int i, int j)
 {
         assert(array2b != NULL);
-        assert(i >= 0 && j >= 0);
         /* avoid unused cells */
-        assert(i < array2b->width && j < array2b->height);
-        int b = array2b->blocksize;
-        int bx = i / b; /* block x coordinate */
-        int by = j / b; /* block y coordinate */
-        UArray_T *blockp = UArray2_at(array2b->blocks, bx, by);
-        return UArray_at(*blockp, (i % b) * b + j % b);
+        assert((unsigned) i < (unsigned) array2b->width &&
+               (unsigned) j < (unsigned) array2b->height);
+        i += array2b->col0;
+        j += array2b->row0;
+        unsigned shift = array2b->shift;
+        unsigned mask = array2b->mask;
+        long block = (long) (i >> shift) * array2b->yblocks + (j >> shift);
+        long cell = (block << (2 * shift)) | ((i & mask) << shift) | (j & mask);
+        return array2b->slab + cell * array2b->size;
 }
 
 void UArray2b_map(T array2b,
@@ -131,33 +157,55 @@ void UArray2b_map(T array2b,
 
         int h = array2b->height;
         int w = array2b->width;
-        int b = array2b->blocksize;
-        UArray2_T blocks = array2b->blocks;
-        int bw = UArray2_width(blocks);
-        int bh = UArray2_height(blocks);
-
-        for (int bx = 0; bx < bw; bx++) {
-                for (int by = 0; by < bh; by++) {
-                        UArray_T *blockp = UArray2_at(blocks, bx, by);
-                        UArray_T block = *blockp;
-                        int len = UArray_length(block);
+        if (w == 0 || h == 0) {
+                return;
+        }
+        unsigned shift = array2b->shift;
+        unsigned mask = array2b->mask;
+        int len = 1 << (2 * shift);
+        unsigned size = array2b->size;
+        int col0 = array2b->col0;
+        int row0 = array2b->row0;
+
+        /* only the blocks that overlap the array (or view) are visited */
+        for (int bx = col0 >> shift; bx <= (col0 + w - 1) >> shift; bx++) {
+                for (int by = row0 >> shift; by <= (row0 + h - 1) >> shift;
+                     by++) {
+                        long block = (long) bx * array2b->yblocks + by;
+                        char *elem = array2b->slab +
+                                     (block << (2 * shift)) * size;
                         /* (i0, j0) correspond to upper left */
                         /* corner of block (bx, by)          */
-                        int i0 = b * bx;
-                        int j0 = b * by;
+                        int i0 = (bx << shift) - col0;
+                        int j0 = (by << shift) - row0;
                         for (int cell = 0; cell < len; cell++) {
-                                int i = i0 + cell / b;
-                                int j = j0 + cell % b;
+                                int i = i0 + (cell >> shift);
+                                int j = j0 + (cell & mask);
                                 /* measured overhead 0.5% to 1.5% */
-                                if (i < w && j < h) {
-                                        apply(i, j, array2b,
-                                              UArray_at(block, cell), cl);
+                                if ((unsigned) i < (unsigned) w &&
+                                    (unsigned) j < (unsigned) h) {
+                                        apply(i, j, array2b, elem, cl);
                                 }
+                                elem += size;
                         }
                 }
         }
 }
 
+void *UArray2b_span(T array2b, int i, int j, int *count, int *stride)
+{
+        assert(array2b != NULL && count != NULL && stride != NULL);
+        assert(*count > 0 && i + *count <= array2b->width);
+        /* cells (i, j), (i + 1, j), ... are blocksize cells apart until
+           the run reaches the next block */
+        int room = array2b->blocksize - ((i + array2b->col0) & array2b->mask);
+        if (*count > room) {
+                *count = room;
+        }
+        *stride = array2b->blocksize * array2b->size;
+        return UArray2b_at(array2b, i, j);
+}
+
 int UArray2b_height(T array2b)
 {
         assert(array2b != NULL);
@@ -181,4 +229,4 @@ int UArray2b_blocksize(T array2b)
         return array2b->blocksize;
 }
 
-int UArray2b_version_uses_UArray2_T = 1;
+int UArray2b_version_uses_UArray2_T = 0;
@@ -0,0 +1,82 @@
+/**************************************************************
+ *                     uarray2b.h
+ *
+ *     Assignment: arith
+ *     Authors:  Diana Calderon and Madeline Lei
+ *     Usernames: dcalde02, mlei03
+ *     Date:     10/21/2025
+ *
+ *     summary
+ *
+ *     This file contains an interface for a UArray2b, a 2D array whose
+ *     elements are stored in square blocks. It contains the functions
+ *     that the client can use to create, edit, and delete an instance of
+ *     a UArray2b.
+ *
+ *     NOTE: This file was provided by the course. It has been changed to
+ *     say that uarray2b.c only takes power-of-two blocks, and to declare
+ *     UArray2b_view and UArray2b_span.
+ *
+**************************************************************/
+
+#ifndef UARRAY2B_INCLUDED
+#define UARRAY2B_INCLUDED
+#define T UArray2b_T
+typedef struct T *T;
+
+/*
+ * new blocked 2d array
+ * blocksize = square root of # of cells in block; it must be a power of
+ * two so that finding a cell takes shifts and masks, and
+ * UArray2b_blocksize() returns exactly the blocksize given here.
+ * blocksize < 1, or a blocksize that is not a power of two, is a checked
+ * runtime error
+ */
+extern T UArray2b_new(int width, int height, int size, int blocksize);
+
+/*
+ * new blocked 2d array: blocksize is the largest power of two whose block
+ * occupies at most 64KB (if possible)
+ */
+extern T UArray2b_new_64K_block(int width, int height, int size);
+
+/*
+ * a view is a width by height window of parent starting at (i, j) that
+ * shares parent's slab; UArray2b_free on a view leaves the slab alone, and
+ * parent must outlive the view
+ */
+extern T UArray2b_view(T parent, int i, int j, int width, int height);
+
+extern void UArray2b_free(T *array2b);
+
+extern int UArray2b_width(T array2b);
+extern int UArray2b_height(T array2b);
+extern int UArray2b_size(T array2b);
+extern int UArray2b_blocksize(T array2b);
+
+/*
+ * return a pointer to the cell in the given column and row.
+ * index out of range is a checked run-time error
+ */
+extern void *UArray2b_at(T array2b, int column, int row);
+
+/*
+ * returns a pointer to (i, j) and shortens *count to the cells from there
+ * that are *stride bytes apart (the rest of row j inside one block).
+ * *count < 1 or i + *count past the width is a checked run-time error
+ */
+extern void *UArray2b_span(T array2b, int i, int j, int *count, int *stride);
+
+/* visits every cell in one block before moving to another block */
+extern void UArray2b_map(T array2b,
+                         void apply(int col, int row, T array2b, void *elem,
+                                    void *cl),
+                         void *cl);
+
+/*
+ * it is a checked run-time error to pass a NULL T
+ * to any function in this interface
+ */
+
+#undef T
+#endif